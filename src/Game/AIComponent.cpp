@@ -1,13 +1,272 @@
 #include "AIComponent.h"
 
 #include "GameObjects/Tank.h"
+#include "FlowField.h"
+#include "ThreatMap.h"
+#include "WorldState.h"
+#include "AIScheduler.h"
+#include "../System/Snapshot.h"
+
+#include <cmath>
+#include <glm/common.hpp>
+#include <algorithm>
+
+// in the order of ThreatMap::EDirection
+static const std::array<glm::ivec2, 4> DIRECTIONS = {
+	glm::ivec2(0, 1),
+	glm::ivec2(0, -1),
+	glm::ivec2(-1, 0),
+	glm::ivec2(1, 0)
+};
 
 AIComponent::AIComponent(Tank* parentTank) 
 	: m_parentTank(parentTank)
+	, m_navigationGrid(nullptr)
+	, m_targetField(nullptr)
+	, m_threatMap(nullptr)
+	, m_worldState(nullptr)
+	, m_worldIndex(0)
+	, m_scheduler(nullptr)
+	, m_schedulerIndex(AIScheduler::INVALID_INDEX)
 {
+	m_flowFields.fill(nullptr);
+	m_isDirectionSafe.fill(true);
+}
+
+AIComponent::~AIComponent() {
+	unschedule();
+}
+
+void AIComponent::unschedule() {
+	if (m_scheduler) {
+		m_scheduler->remove(*this);
+	}
+}
+
+void AIComponent::saveState(SnapshotWriter& writer) const {
+	uint8_t targetField = NO_FLOW_FIELD;
+	for (uint8_t currentField = 0; currentField < m_flowFields.size(); ++currentField) {
+		if (m_targetField && m_flowFields[currentField] == m_targetField) {
+			targetField = currentField;
+		}
+	}
+	writer.write(targetField);
+	writer.write(m_isDirectionSafe);
+	writer.write(m_state);
+	writer.write(m_intent);
+	writer.write(static_cast<uint64_t>(m_scheduler ? m_schedulerIndex : AIScheduler::INVALID_INDEX));
+}
+
+bool AIComponent::readState(SnapshotReader& reader, SavedState& state) const {
+	if (!reader.read(state.targetField) || !reader.read(state.isDirectionSafe) || !reader.read(state.state) || !reader.read(state.intent)
+		|| !reader.read(state.schedulerIndex)) {
+		return false;
+	}
+	if (!std::all_of(state.isDirectionSafe.begin(), state.isDirectionSafe.end(), SnapshotReader::isBool)) {
+		return false;
+	}
+	return (state.targetField < m_flowFields.size() || state.targetField == NO_FLOW_FIELD)
+		&& SnapshotReader::isBool(state.state.canAct) && SnapshotReader::isBool(state.intent.startMoving) && SnapshotReader::isBool(state.intent.fire);
+}
+
+void AIComponent::restoreState(const SavedState& state, AIScheduler& scheduler) {
+	m_targetField = state.targetField < m_flowFields.size() ? m_flowFields[state.targetField] : nullptr;
+	m_isDirectionSafe = state.isDirectionSafe;
+	m_state = state.state;
+	m_intent = state.intent;
+	if (state.schedulerIndex != AIScheduler::INVALID_INDEX) {
+		scheduler.restoreEntry(*this, static_cast<size_t>(state.schedulerIndex));
+	}
+}
+
+void AIComponent::setNavigation(const NavigationGrid* navigationGrid, const std::array<const FlowField*, MAX_FLOW_FIELDS>& flowFields, const ThreatMap* threatMap) {
+	m_navigationGrid = navigationGrid;
+	m_flowFields = flowFields;
+	m_threatMap = threatMap;
+	m_targetField = nullptr;
+}
+
+void AIComponent::setWorldState(const WorldState* worldState, const size_t worldIndex) {
+	m_worldState = worldState;
+	m_worldIndex = worldIndex;
+}
 
+void AIComponent::captureState(const double delta) {
+	m_state.position = m_parentTank->getCurrentPosition();
+	m_state.size = m_parentTank->getSize();
+	m_state.direction = m_parentTank->getCurrentDirection();
+	m_state.velocity = m_parentTank->getCurrentVelocity();
+	m_state.maxVelocity = m_parentTank->getMaxVelocity();
+	m_state.step = m_parentTank->getSimulationDelta(delta);
+	m_state.canAct = !m_parentTank->isSpawning() && !m_parentTank->isDestroyed() && m_state.step > 0;
 }
 
-void AIComponent::update(const double delta) {
-	m_parentTank->fire();
+void AIComponent::makeDecision() {
+	if (!m_navigationGrid) {
+		return;
+	}
+
+	const uint32_t nodeIndex = m_navigationGrid->getNodeIndex(m_navigationGrid->getNode(m_state.position));
+	m_targetField = nullptr;
+	for (const FlowField* currentField : m_flowFields) {
+		if (currentField && currentField->hasGoal() && currentField->getDistance(nodeIndex) != FlowField::UNREACHABLE
+			&& (!m_targetField || currentField->getDistance(nodeIndex) < m_targetField->getDistance(nodeIndex))) {
+			m_targetField = currentField;
+		}
+	}
+
+	m_isDirectionSafe.fill(true);
+	if (!m_worldState || m_worldIndex >= m_worldState->tanksCount) {
+		return;
+	}
+	// every other tank keeps going, this one drives straight in the direction
+	for (size_t currentDirection = 0; currentDirection < DIRECTIONS.size(); ++currentDirection) {
+		WorldState rollout = *m_worldState;
+		WorldState::Actions actions = rollout.getCurrentActions();
+		actions[m_worldIndex] = { DIRECTIONS[currentDirection], true, false };
+		rollout.simulate(actions, ROLLOUT_TIME, ROLLOUT_STEP);
+		m_isDirectionSafe[currentDirection] = !rollout.tanks[m_worldIndex].isDestroyed;
+	}
+}
+
+void AIComponent::planIntent() {
+	m_intent = Intent();
+	if (!m_state.canAct) {
+		return;
+	}
+
+	// shoot at a target in sight or at bricks in the way, not at concrete
+	if (m_threatMap) {
+		const Physics::AABB lane(m_state.position + m_state.size / 4.f, m_state.position + m_state.size * 3.f / 4.f);
+		const ThreatMap::LineOfFire lineOfFire = m_threatMap->getLineOfFire(lane, glm::ivec2(m_state.direction));
+		m_intent.fire = lineOfFire.hasTarget || lineOfFire.isObstacleDestructible;
+	}
+	else {
+		m_intent.fire = true;
+	}
+
+	if (!m_navigationGrid) {
+		return;
+	}
+
+	// the tank can only turn on the lattice, in between it keeps going
+	const glm::ivec2 node = m_navigationGrid->getNode(m_state.position);
+	const glm::vec2 offset = glm::abs(m_state.position - m_navigationGrid->getNodePosition(node));
+	const float tolerance = std::max(1.f, static_cast<float>(m_state.maxVelocity * m_state.step / 2.0));
+	if (offset.x > tolerance || offset.y > tolerance) {
+		return;
+	}
+
+	glm::ivec2 direction(0, 0);
+	const uint8_t threats = m_threatMap ? m_threatMap->getThreats(Physics::AABB(m_state.position, m_state.position + m_state.size)) : 0;
+	if (threats) {
+		direction = findDodgeDirection(node, threats);
+	}
+	// the field may have lost its goal since the last decision
+	if (direction == glm::ivec2(0, 0) && m_targetField && m_targetField->hasGoal()) {
+		direction = m_targetField->getDirection(m_navigationGrid->getNodeIndex(node));
+	}
+	if (direction == glm::ivec2(0, 0)) {
+		return;
+	}
+	if (!m_isDirectionSafe[static_cast<size_t>(ThreatMap::getDirection(direction))]) {
+		const glm::ivec2 safeDirection = findSafeDirection(node);
+		if (safeDirection != glm::ivec2(0, 0)) {
+			direction = safeDirection;
+		}
+	}
+	if (glm::vec2(direction) != m_state.direction) {
+		m_intent.direction = direction;
+	}
+	m_intent.startMoving = m_state.velocity == 0;
+}
+
+glm::ivec2 AIComponent::findDodgeDirection(const glm::ivec2& node, const uint8_t threats) const {
+	const uint8_t verticalThreats = (1 << static_cast<uint8_t>(ThreatMap::EDirection::Top)) | (1 << static_cast<uint8_t>(ThreatMap::EDirection::Bottom));
+	const bool isThreatenedVertically = (threats & verticalThreats) != 0;
+	const bool isThreatenedHorizontally = (threats & ~verticalThreats) != 0;
+	// caught between crossing paths, sidestepping one only leads into the other
+	if (isThreatenedVertically == isThreatenedHorizontally) {
+		return glm::ivec2(0, 0);
+	}
+
+	const std::array<glm::ivec2, 2> candidates = isThreatenedVertically
+		? std::array<glm::ivec2, 2>{ glm::ivec2(-1, 0), glm::ivec2(1, 0) }
+		: std::array<glm::ivec2, 2>{ glm::ivec2(0, -1), glm::ivec2(0, 1) };
+	glm::ivec2 bestDirection(0, 0);
+	uint32_t bestDistance = FlowField::UNREACHABLE;
+	for (const auto& currentDirection : candidates) {
+		// a free node out of the paths within a few steps, the way there must not cross bricks either
+		bool isEscape = false;
+		for (size_t step = 1; step <= NavigationGrid::TANK_CELLS + 2; ++step) {
+			const glm::ivec2 currentNode = node + currentDirection * static_cast<int>(step);
+			if (currentNode.x < 0 || currentNode.y < 0
+				|| currentNode.x >= static_cast<int>(m_navigationGrid->getWidthNodes()) || currentNode.y >= static_cast<int>(m_navigationGrid->getHeightNodes())
+				|| m_navigationGrid->getNodeCost(m_navigationGrid->getNodeIndex(currentNode)) != 0) {
+				break;
+			}
+			const glm::vec2 position = m_navigationGrid->getNodePosition(currentNode);
+			if (!m_threatMap->isThreatened(Physics::AABB(position, position + m_state.size))) {
+				isEscape = true;
+				break;
+			}
+		}
+		if (!isEscape) {
+			continue;
+		}
+
+		const uint32_t neighborNode = m_navigationGrid->getNodeIndex(node + currentDirection);
+		// of two free sides the one closer to the target
+		const uint32_t distance = m_targetField && m_targetField->hasGoal() ? m_targetField->getDistance(neighborNode) : FlowField::UNREACHABLE;
+		if (bestDirection == glm::ivec2(0, 0) || distance < bestDistance) {
+			bestDirection = currentDirection;
+			bestDistance = distance;
+		}
+	}
+	return bestDirection;
+}
+
+glm::ivec2 AIComponent::findSafeDirection(const glm::ivec2& node) const {
+	glm::ivec2 bestDirection(0, 0);
+	uint32_t bestDistance = FlowField::UNREACHABLE;
+	for (size_t currentDirection = 0; currentDirection < DIRECTIONS.size(); ++currentDirection) {
+		const glm::ivec2 neighbor = node + DIRECTIONS[currentDirection];
+		if (!m_isDirectionSafe[currentDirection] || neighbor.x < 0 || neighbor.y < 0
+			|| neighbor.x >= static_cast<int>(m_navigationGrid->getWidthNodes()) || neighbor.y >= static_cast<int>(m_navigationGrid->getHeightNodes())) {
+			continue;
+		}
+		const uint32_t neighborNode = m_navigationGrid->getNodeIndex(neighbor);
+		if (m_navigationGrid->getNodeCost(neighborNode) == NavigationGrid::BLOCKED) {
+			continue;
+		}
+		const uint32_t distance = m_targetField && m_targetField->hasGoal() ? m_targetField->getDistance(neighborNode) : FlowField::UNREACHABLE;
+		if (bestDirection == glm::ivec2(0, 0) || distance < bestDistance) {
+			bestDirection = DIRECTIONS[currentDirection];
+			bestDistance = distance;
+		}
+	}
+	return bestDirection;
+}
+
+void AIComponent::applyIntent() {
+	if (m_intent.fire) {
+		m_parentTank->fire();
+	}
+
+	if (m_intent.direction.y > 0) {
+		m_parentTank->setOrientation(Tank::EOrientation::Top);
+	}
+	else if (m_intent.direction.y < 0) {
+		m_parentTank->setOrientation(Tank::EOrientation::Bottom);
+	}
+	else if (m_intent.direction.x < 0) {
+		m_parentTank->setOrientation(Tank::EOrientation::Left);
+	}
+	else if (m_intent.direction.x > 0) {
+		m_parentTank->setOrientation(Tank::EOrientation::Right);
+	}
+	if (m_intent.startMoving) {
+		m_parentTank->setVelocity(m_parentTank->getMaxVelocity());
+	}
+	m_intent = Intent();
 }
\ No newline at end of file
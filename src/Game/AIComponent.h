@@ -1,13 +1,107 @@
 #pragma once
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <glm/vec2.hpp>
+
 class Tank;
+class NavigationGrid;
+class FlowField;
+class ThreatMap;
+class AIScheduler;
+struct WorldState;
+class SnapshotWriter;
+class SnapshotReader;
 
+// Decisions of an enemy tank. They are made from a copy of the tank state taken before the
+// decision pass and only produce an intent, so components can decide in parallel while
+// the tanks themselves are changed by applying the intents one by one.
 class AIComponent {
 public:
+	static constexpr size_t MAX_FLOW_FIELDS = 3;
+	// a decision looks this far ahead (ms), past the next decision
+	static constexpr double ROLLOUT_TIME = 300;
+	static constexpr float ROLLOUT_STEP = 1000.f / 60.f;
+
+	// what the decision pass may read about the tank
+	struct TankState {
+		glm::vec2 position = glm::vec2(0);
+		glm::vec2 size = glm::vec2(0);
+		glm::vec2 direction = glm::vec2(0);
+		double velocity = 0;
+		double maxVelocity = 0;
+		// simulated time of the tank this tick, 0 if its update is skipped
+		double step = 0;
+		bool canAct = false;
+	};
+
+	// what the tank is asked to do this tick
+	struct Intent {
+		// (0, 0) keeps the current orientation
+		glm::ivec2 direction = glm::ivec2(0);
+		bool startMoving = false;
+		bool fire = false;
+	};
+
 	AIComponent(Tank* parentTank);
+	~AIComponent();
 
-	void update(const double delta);
+	// the tank follows the field whose goal is the closest to it, fields without a goal are skipped;
+	// the threat map tells it when to fire and when to get out of the way of a bullet
+	void setNavigation(const NavigationGrid* navigationGrid, const std::array<const FlowField*, MAX_FLOW_FIELDS>& flowFields, const ThreatMap* threatMap);
+	// copy of the level the decisions roll out from, the tank is worldIndex in it
+	void setWorldState(const WorldState* worldState, const size_t worldIndex);
+	// copies the tank state, must not run during the decision pass
+	void captureState(const double delta);
+	// picks the field to follow and rolls out every direction to see which ones get the tank destroyed,
+	// called by the scheduler once per replan interval
+	void makeDecision();
+	// follows the picked field, called every tick after the decision
+	void planIntent();
+	// carries the intent out on the tank, must not run during the decision pass
+	void applyIntent();
+	void unschedule();
+	// what carries over from one tick to the next; the navigation has to be set before a restore,
+	// the scheduler has to be restored first
+	struct SavedState {
+		uint8_t targetField = NO_FLOW_FIELD;
+		std::array<bool, 4> isDirectionSafe{};
+		TankState state;
+		Intent intent;
+		// entry of the component in the scheduler, checked by the level against the entries of the scheduler
+		uint64_t schedulerIndex = std::numeric_limits<uint64_t>::max();
+	};
+	void saveState(SnapshotWriter& writer) const;
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	void restoreState(const SavedState& state, AIScheduler& scheduler);
+
+	const TankState& getState() const { return m_state; }
+	const Intent& getIntent() const { return m_intent; }
 
 private:
+	friend class AIScheduler;
+
+	// saved in place of the target field that is not set
+	static constexpr uint8_t NO_FLOW_FIELD = 0xFF;
+
+	// a direction along the lattice out of the bullet paths, (0, 0) if there is none
+	glm::ivec2 findDodgeDirection(const glm::ivec2& node, const uint8_t threats) const;
+	// a direction the rollouts found safe, the one closest to the target first; (0, 0) if there is none
+	glm::ivec2 findSafeDirection(const glm::ivec2& node) const;
+
 	Tank* m_parentTank;
+	const NavigationGrid* m_navigationGrid;
+	std::array<const FlowField*, MAX_FLOW_FIELDS> m_flowFields;
+	const FlowField* m_targetField;
+	const ThreatMap* m_threatMap;
+	const WorldState* m_worldState;
+	size_t m_worldIndex;
+	// by the directions of ThreatMap::EDirection
+	std::array<bool, 4> m_isDirectionSafe;
+	TankState m_state;
+	Intent m_intent;
+	AIScheduler* m_scheduler;
+	size_t m_schedulerIndex;
 };
\ No newline at end of file
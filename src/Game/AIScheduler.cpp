@@ -0,0 +1,195 @@
+#include "AIScheduler.h"
+
+#include "AIComponent.h"
+#include "../System/ThreadPool.h"
+#include "../System/Snapshot.h"
+
+#include <cmath>
+#include <algorithm>
+
+AIScheduler::AIScheduler(const double replanInterval, const double budget, ThreadPool* threadPool)
+	: m_threadPool(threadPool)
+	, m_replanInterval(replanInterval)
+	, m_budget(budget)
+	, m_time(0)
+	, m_nextPhase(0)
+	, m_cursor(0)
+	, m_decisionCost(0)
+	, m_pendingDecisions(0)
+	, m_decisionsInWindow(0)
+	, m_windowTime(0)
+{
+}
+
+AIScheduler::~AIScheduler() {
+	for (const Entry& currentEntry : m_entries) {
+		currentEntry.component->m_scheduler = nullptr;
+		currentEntry.component->m_schedulerIndex = INVALID_INDEX;
+	}
+}
+
+void AIScheduler::add(AIComponent& component) {
+	if (component.m_scheduler == this) {
+		return;
+	}
+	if (component.m_scheduler) {
+		component.m_scheduler->remove(component);
+	}
+
+	component.m_scheduler = this;
+	component.m_schedulerIndex = m_entries.size();
+	m_entries.push_back({ &component, m_time + m_nextPhase, false });
+
+	// golden ratio steps keep the phases of any number of components spread over the interval
+	m_nextPhase = std::fmod(m_nextPhase + m_replanInterval * 0.618034, m_replanInterval);
+	m_metrics.scheduledCount = m_entries.size();
+}
+
+void AIScheduler::remove(AIComponent& component) {
+	if (component.m_scheduler != this) {
+		return;
+	}
+
+	const size_t index = component.m_schedulerIndex;
+	if (index != m_entries.size() - 1) {
+		m_entries[index] = m_entries.back();
+		m_entries[index].component->m_schedulerIndex = index;
+	}
+	m_entries.pop_back();
+
+	component.m_scheduler = nullptr;
+	component.m_schedulerIndex = INVALID_INDEX;
+	m_metrics.scheduledCount = m_entries.size();
+}
+
+void AIScheduler::saveState(SnapshotWriter& writer) const {
+	writer.write(m_time);
+	writer.write(m_nextPhase);
+	writer.write(static_cast<uint64_t>(m_cursor));
+	// laid out as an array of the decision times
+	writer.write(static_cast<uint64_t>(m_entries.size()));
+	for (const Entry& currentEntry : m_entries) {
+		writer.write(currentEntry.nextDecisionTime);
+	}
+}
+
+bool AIScheduler::readState(SnapshotReader& reader, SavedState& state) const {
+	if (!reader.read(state.time) || !reader.read(state.nextPhase) || !reader.read(state.cursor) || !reader.readVector(state.decisionTimes)) {
+		return false;
+	}
+	return state.cursor < state.decisionTimes.size() || state.cursor == 0;
+}
+
+void AIScheduler::restoreState(const SavedState& state) {
+	for (const Entry& currentEntry : m_entries) {
+		currentEntry.component->m_scheduler = nullptr;
+		currentEntry.component->m_schedulerIndex = INVALID_INDEX;
+	}
+	m_entries.clear();
+	for (const double currentDecisionTime : state.decisionTimes) {
+		m_entries.push_back({ nullptr, currentDecisionTime, false });
+	}
+	m_time = state.time;
+	m_nextPhase = state.nextPhase;
+	m_cursor = static_cast<size_t>(state.cursor);
+	m_metrics.scheduledCount = m_entries.size();
+}
+
+void AIScheduler::restoreEntry(AIComponent& component, const size_t index) {
+	if (index >= m_entries.size()) {
+		return;
+	}
+	if (component.m_scheduler && component.m_scheduler != this) {
+		component.m_scheduler->remove(component);
+	}
+	m_entries[index].component = &component;
+	component.m_scheduler = this;
+	component.m_schedulerIndex = index;
+}
+
+size_t AIScheduler::chooseDecisions() {
+	size_t maxDecisions = m_entries.size();
+	if (m_budget > 0 && m_decisionCost > 0) {
+		// at least one decision per tick, so the scheduler always makes progress
+		maxDecisions = std::max<size_t>(1, static_cast<size_t>(m_budget / m_decisionCost));
+	}
+
+	size_t decisions = 0;
+	size_t firstPostponedEntry = m_entries.size();
+	m_pendingDecisions = 0;
+	for (size_t visitedEntries = 0; visitedEntries < m_entries.size(); ++visitedEntries) {
+		Entry& entry = m_entries[(m_cursor + visitedEntries) % m_entries.size()];
+		entry.isDecisionDue = false;
+		if (entry.nextDecisionTime > m_time) {
+			continue;
+		}
+		if (decisions == maxDecisions) {
+			if (m_pendingDecisions == 0) {
+				firstPostponedEntry = visitedEntries;
+			}
+			++m_pendingDecisions;
+			continue;
+		}
+		entry.isDecisionDue = true;
+		++decisions;
+		// a late component keeps its phase instead of catching up with a burst of decisions
+		entry.nextDecisionTime += m_replanInterval;
+		if (entry.nextDecisionTime <= m_time) {
+			entry.nextDecisionTime = m_time + m_replanInterval;
+		}
+	}
+
+	if (m_pendingDecisions > 0) {
+		// the next tick starts from the first postponed decision
+		m_cursor = (m_cursor + firstPostponedEntry) % m_entries.size();
+	}
+	return decisions;
+}
+
+void AIScheduler::runEntry(const size_t index) {
+	const Entry& entry = m_entries[index];
+	if (entry.isDecisionDue) {
+		entry.component->makeDecision();
+	}
+	entry.component->planIntent();
+}
+
+void AIScheduler::update(const double delta) {
+	m_time += delta;
+
+	// nothing changes the tanks until the intents are applied
+	for (const Entry& currentEntry : m_entries) {
+		currentEntry.component->captureState(delta);
+	}
+
+	const size_t decisions = chooseDecisions();
+	const auto passStartTime = std::chrono::high_resolution_clock::now();
+	if (m_threadPool) {
+		m_threadPool->parallelFor(m_entries.size(), [this](const size_t index) { runEntry(index); });
+	}
+	else {
+		for (size_t index = 0; index < m_entries.size(); ++index) {
+			runEntry(index);
+		}
+	}
+	const double passTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - passStartTime).count();
+	if (decisions > 0) {
+		m_decisionCost = passTime / decisions;
+	}
+
+	const bool isOverBudget = m_pendingDecisions > 0;
+	m_metrics.decisionsLastTick = decisions;
+	m_metrics.pendingDecisions = m_pendingDecisions;
+	m_metrics.lastTickTime = passTime;
+	if (isOverBudget) {
+		++m_metrics.budgetOverruns;
+	}
+
+	m_decisionsInWindow += decisions;
+	m_windowTime += delta;
+	if (m_windowTime >= 1000.0) {
+		m_metrics.decisionsPerSecond = m_decisionsInWindow * 1000.0 / m_windowTime;
+		m_decisionsInWindow = 0;
+		m_windowTime = 0;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <chrono>
+
+class AIComponent;
+class ThreadPool;
+class SnapshotWriter;
+class SnapshotReader;
+
+// Spreads the decisions of the AI components over time: every component decides once per
+// replan interval, with phases offset so that the decisions don't fall on the same tick.
+// The time budget of a tick is turned into a number of decisions with the cost per decision
+// measured on the previous ticks, the due decisions over that number are made next tick.
+// The decisions are chosen before the pass, which then runs on the worker pool over the states
+// captured before it; the intents are applied by the tanks afterwards in their usual order.
+class AIScheduler {
+public:
+	static constexpr size_t INVALID_INDEX = std::numeric_limits<size_t>::max();
+
+	struct Metrics {
+		size_t scheduledCount = 0;
+		size_t decisionsLastTick = 0;
+		// decisions that were due but postponed to the next tick
+		size_t pendingDecisions = 0;
+		// ticks that ran out of budget since the level start
+		size_t budgetOverruns = 0;
+		// averaged over the last full second
+		double decisionsPerSecond = 0;
+		// time spent making decisions during the last tick (ms)
+		double lastTickTime = 0;
+	};
+
+	// budget is in ms per tick, 0 means no limit; without a thread pool the pass runs on the calling thread
+	AIScheduler(const double replanInterval, const double budget, ThreadPool* threadPool = nullptr);
+	~AIScheduler();
+
+	AIScheduler(const AIScheduler&) = delete;
+	AIScheduler& operator = (const AIScheduler&) = delete;
+
+	void add(AIComponent& component);
+	void remove(AIComponent& component);
+	// captures the tank states and plans the intents of every component
+	void update(const double delta);
+
+	void setBudget(const double budget) { m_budget = budget; }
+	double getBudget() const { return m_budget; }
+	void setThreadPool(ThreadPool* threadPool) { m_threadPool = threadPool; }
+	const Metrics& getMetrics() const { return m_metrics; }
+
+	// clock and decision times of the entries; the components are not part of the state,
+	// every one of them takes its saved place again through restoreEntry
+	struct SavedState {
+		double time = 0;
+		double nextPhase = 0;
+		uint64_t cursor = 0;
+		std::vector<double> decisionTimes;
+	};
+	void saveState(SnapshotWriter& writer) const;
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	// the entries are left without components, every one of them has to be claimed once through restoreEntry
+	void restoreState(const SavedState& state);
+	void restoreEntry(AIComponent& component, const size_t index);
+
+private:
+	struct Entry {
+		AIComponent* component;
+		double nextDecisionTime;
+		// chosen to decide during the current pass
+		bool isDecisionDue;
+	};
+
+	// marks the due entries the budget allows and returns their count
+	size_t chooseDecisions();
+	void runEntry(const size_t index);
+
+	std::vector<Entry> m_entries;
+	ThreadPool* m_threadPool;
+	double m_replanInterval;
+	double m_budget;
+	double m_time;
+	// phase of the next added component
+	double m_nextPhase;
+	// entry the next tick starts from, so postponed decisions are made first
+	size_t m_cursor;
+
+	// measured on the last tick that made decisions (ms), 0 until then
+	double m_decisionCost;
+	size_t m_pendingDecisions;
+
+	size_t m_decisionsInWindow;
+	double m_windowTime;
+	Metrics m_metrics;
+};
\ No newline at end of file
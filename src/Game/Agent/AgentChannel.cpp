@@ -0,0 +1,209 @@
+#include "AgentChannel.h"
+
+#include <iostream>
+#include <new>
+#include <chrono>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// polls before going to sleep, a waiting agent usually gets the next frame within microseconds
+static constexpr size_t SPIN_COUNT = 2000;
+
+#if defined(__linux__)
+static void waitOnFutex(std::atomic<uint32_t>& word, const uint32_t expected, const double timeout) {
+	timespec relativeTimeout;
+	if (timeout >= 0) {
+		relativeTimeout.tv_sec = static_cast<time_t>(timeout / 1000.0);
+		relativeTimeout.tv_nsec = static_cast<long>((timeout - relativeTimeout.tv_sec * 1000.0) * 1000000.0);
+	}
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, timeout >= 0 ? &relativeTimeout : nullptr, nullptr, 0);
+}
+
+static void wakeFutex(std::atomic<uint32_t>& word) {
+	syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+#endif
+
+AgentChannel::AgentChannel(Agent::SharedBlock* block, const std::string& name, const bool isOwner)
+	: m_block(block)
+	, m_name(name)
+	, m_isOwner(isOwner)
+{
+}
+
+std::unique_ptr<AgentChannel> AgentChannel::create(const std::string& name) {
+#if defined(__linux__)
+	const int descriptor = shm_open(name.c_str(), O_CREAT | O_RDWR | O_TRUNC, 0600);
+	if (descriptor < 0) {
+		std::cerr << "Can't create shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		return nullptr;
+	}
+	if (ftruncate(descriptor, sizeof(Agent::SharedBlock)) != 0) {
+		std::cerr << "Can't resize shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		close(descriptor);
+		shm_unlink(name.c_str());
+		return nullptr;
+	}
+	void* memory = mmap(nullptr, sizeof(Agent::SharedBlock), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (memory == MAP_FAILED) {
+		std::cerr << "Can't map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		shm_unlink(name.c_str());
+		return nullptr;
+	}
+
+	Agent::SharedBlock* block = new (memory) Agent::SharedBlock();
+	block->version = Agent::PROTOCOL_VERSION;
+	block->blockSize = sizeof(Agent::SharedBlock);
+	block->observations.head = 0;
+	block->observations.tail = 0;
+	block->observations.waiters = 0;
+	block->actions.head = 0;
+	block->actions.tail = 0;
+	block->actions.waiters = 0;
+	block->magic.store(Agent::PROTOCOL_MAGIC, std::memory_order_release);
+	return std::unique_ptr<AgentChannel>(new AgentChannel(block, name, true));
+#else
+	std::cerr << "Agent channels need POSIX shared memory and futexes, can't create " << name << std::endl;
+	return nullptr;
+#endif
+}
+
+std::unique_ptr<AgentChannel> AgentChannel::open(const std::string& name) {
+#if defined(__linux__)
+	const int descriptor = shm_open(name.c_str(), O_RDWR, 0600);
+	if (descriptor < 0) {
+		std::cerr << "Can't open shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		return nullptr;
+	}
+	void* memory = mmap(nullptr, sizeof(Agent::SharedBlock), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+	close(descriptor);
+	if (memory == MAP_FAILED) {
+		std::cerr << "Can't map shared memory " << name << ": " << std::strerror(errno) << std::endl;
+		return nullptr;
+	}
+
+	Agent::SharedBlock* block = static_cast<Agent::SharedBlock*>(memory);
+	if (block->magic.load(std::memory_order_acquire) != Agent::PROTOCOL_MAGIC
+		|| block->version != Agent::PROTOCOL_VERSION || block->blockSize != sizeof(Agent::SharedBlock)) {
+		std::cerr << "Shared memory " << name << " is not an agent channel of this version" << std::endl;
+		munmap(memory, sizeof(Agent::SharedBlock));
+		return nullptr;
+	}
+	return std::unique_ptr<AgentChannel>(new AgentChannel(block, name, false));
+#else
+	std::cerr << "Agent channels need POSIX shared memory and futexes, can't open " << name << std::endl;
+	return nullptr;
+#endif
+}
+
+AgentChannel::~AgentChannel() {
+#if defined(__linux__)
+	munmap(m_block, sizeof(Agent::SharedBlock));
+	if (m_isOwner) {
+		shm_unlink(m_name.c_str());
+	}
+#endif
+}
+
+template <class Frame>
+Frame* AgentChannel::beginWrite(Agent::Ring<Frame>& ring) {
+	const uint32_t head = ring.head.load(std::memory_order_relaxed);
+	if (head - ring.tail.load(std::memory_order_acquire) == Agent::RING_SIZE) {
+		return nullptr;
+	}
+	return &ring.frames[head % Agent::RING_SIZE];
+}
+
+template <class Frame>
+void AgentChannel::commitWrite(Agent::Ring<Frame>& ring) {
+	// sequentially consistent with the check of the waiting side, so one of them sees the other
+	ring.head.fetch_add(1);
+#if defined(__linux__)
+	if (ring.waiters.load() > 0) {
+		wakeFutex(ring.head);
+	}
+#endif
+}
+
+template <class Frame>
+const Frame* AgentChannel::waitForRead(Agent::Ring<Frame>& ring, const double timeout) {
+	const uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+	for (size_t currentSpin = 0; currentSpin < SPIN_COUNT; ++currentSpin) {
+		if (ring.head.load(std::memory_order_acquire) != tail) {
+			return &ring.frames[tail % Agent::RING_SIZE];
+		}
+	}
+
+#if defined(__linux__)
+	const auto startTime = std::chrono::steady_clock::now();
+	while (true) {
+		++ring.waiters;
+		const uint32_t head = ring.head.load();
+		if (head == tail) {
+			double remainingTime = -1;
+			if (timeout >= 0) {
+				remainingTime = timeout - std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+				if (remainingTime <= 0) {
+					--ring.waiters;
+					return nullptr;
+				}
+			}
+			waitOnFutex(ring.head, head, remainingTime);
+		}
+		--ring.waiters;
+		if (ring.head.load(std::memory_order_acquire) != tail) {
+			return &ring.frames[tail % Agent::RING_SIZE];
+		}
+	}
+#else
+	return nullptr;
+#endif
+}
+
+template <class Frame>
+void AgentChannel::popRead(Agent::Ring<Frame>& ring) {
+	ring.tail.fetch_add(1, std::memory_order_release);
+}
+
+Agent::ObservationFrame* AgentChannel::beginObservation() {
+	return beginWrite(m_block->observations);
+}
+
+void AgentChannel::commitObservation() {
+	commitWrite(m_block->observations);
+}
+
+const Agent::ActionFrame* AgentChannel::waitForAction(const double timeout) {
+	return waitForRead(m_block->actions, timeout);
+}
+
+void AgentChannel::popAction() {
+	popRead(m_block->actions);
+}
+
+const Agent::ObservationFrame* AgentChannel::waitForObservation(const double timeout) {
+	return waitForRead(m_block->observations, timeout);
+}
+
+void AgentChannel::popObservation() {
+	popRead(m_block->observations);
+}
+
+Agent::ActionFrame* AgentChannel::beginAction() {
+	return beginWrite(m_block->actions);
+}
+
+void AgentChannel::commitAction() {
+	commitWrite(m_block->actions);
+}
\ No newline at end of file
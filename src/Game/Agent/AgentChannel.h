@@ -0,0 +1,50 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <cstdint>
+
+#include "AgentProtocol.h"
+
+// One end of the shared memory connection with an agent process.
+// The game creates the block and owns its name, the agent opens it.
+// Only available on Linux (POSIX shared memory and futexes), elsewhere creation fails.
+class AgentChannel {
+public:
+	// nullptr if the block can't be created or opened
+	static std::unique_ptr<AgentChannel> create(const std::string& name);
+	static std::unique_ptr<AgentChannel> open(const std::string& name);
+	~AgentChannel();
+
+	AgentChannel(const AgentChannel&) = delete;
+	AgentChannel& operator = (const AgentChannel&) = delete;
+
+	// game side: the frame is filled in place and published by commit, nullptr while the ring is full
+	Agent::ObservationFrame* beginObservation();
+	void commitObservation();
+	// nullptr on timeout (ms, negative waits forever), the frame stays valid until popAction
+	const Agent::ActionFrame* waitForAction(const double timeout);
+	void popAction();
+
+	// agent side
+	const Agent::ObservationFrame* waitForObservation(const double timeout);
+	void popObservation();
+	Agent::ActionFrame* beginAction();
+	void commitAction();
+
+private:
+	AgentChannel(Agent::SharedBlock* block, const std::string& name, const bool isOwner);
+
+	template <class Frame>
+	static Frame* beginWrite(Agent::Ring<Frame>& ring);
+	template <class Frame>
+	static void commitWrite(Agent::Ring<Frame>& ring);
+	template <class Frame>
+	static const Frame* waitForRead(Agent::Ring<Frame>& ring, const double timeout);
+	template <class Frame>
+	static void popRead(Agent::Ring<Frame>& ring);
+
+	Agent::SharedBlock* m_block;
+	std::string m_name;
+	bool m_isOwner;
+};
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../WorldState.h"
+
+// Layout of the shared memory block between the game and an external agent process.
+// Both sides map the same block and exchange frames through two single producer,
+// single consumer rings; nothing is serialized, the frames are read in place.
+namespace Agent {
+
+	static constexpr uint32_t PROTOCOL_MAGIC = 0x42434147; // "BCAG"
+	static constexpr uint32_t PROTOCOL_VERSION = 1;
+	static constexpr uint32_t RING_SIZE = 8;
+	static constexpr size_t MAX_PLAYERS = 2;
+
+	struct Action {
+		// one of the axes, (0, 0) stops the tank
+		int8_t directionX;
+		int8_t directionY;
+		uint8_t fire;
+	};
+
+	// written by the agent, applied before the tick
+	struct ActionFrame {
+		uint64_t tick;
+		std::array<Action, MAX_PLAYERS> actions;
+		// restarts the level before applying the actions
+		uint8_t reset;
+	};
+
+	// written by the game after the tick
+	struct ObservationFrame {
+		uint64_t tick;
+		WorldState world;
+		// enemy tanks destroyed by the players during the tick
+		std::array<float, MAX_PLAYERS> rewards;
+		uint8_t isWorldValid;
+		// the level is cleared, the agent has to reset it
+		uint8_t done;
+	};
+
+	// head is written by the producer and tail by the consumer, both only grow;
+	// the consumer sleeps on head with a futex, the producer wakes it only if it announced itself in waiters
+	template <class Frame>
+	struct Ring {
+		alignas(64) std::atomic<uint32_t> head;
+		alignas(64) std::atomic<uint32_t> tail;
+		alignas(64) std::atomic<uint32_t> waiters;
+		std::array<Frame, RING_SIZE> frames;
+	};
+
+	struct SharedBlock {
+		// written last by the game, the agent checks it before using the block
+		std::atomic<uint32_t> magic;
+		uint32_t version;
+		uint32_t blockSize;
+		Ring<ObservationFrame> observations;
+		Ring<ActionFrame> actions;
+	};
+
+	static_assert(std::atomic<uint32_t>::is_always_lock_free, "the rings are shared between processes");
+}
\ No newline at end of file
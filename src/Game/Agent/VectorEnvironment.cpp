@@ -0,0 +1,145 @@
+#include "VectorEnvironment.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "../GameStates/Level.h"
+#include "../../Resources/ResourceManager.h"
+#include "../../System/ThreadPool.h"
+
+VectorEnvironment::VectorEnvironment(const size_t environmentsCount, const size_t levelIndex, const Game::EGameMode eGameMode,
+									 const uint64_t maxEpisodeSteps, ThreadPool* threadPool)
+	: m_environments(environmentsCount)
+	, m_levelIndex(levelIndex)
+	, m_eGameMode(eGameMode)
+	, m_maxEpisodeSteps(maxEpisodeSteps)
+	, m_threadPool(threadPool)
+	, m_observations(environmentsCount)
+	, m_isObservationValid(environmentsCount, 0)
+	, m_rewards(environmentsCount * Agent::MAX_PLAYERS, 0.f)
+	, m_dones(environmentsCount, 0)
+	, m_encodedObservationSize(0)
+{
+	reset();
+}
+
+VectorEnvironment::~VectorEnvironment() {
+	for (auto& currentEnvironment : m_environments) {
+		Physics::PhysicsWorld* previousWorld = Physics::PhysicsEngine::setCurrentWorld(&currentEnvironment.physicsWorld);
+		Physics::PhysicsEngine::terminate();
+		Physics::PhysicsEngine::setCurrentWorld(previousWorld);
+	}
+}
+
+void VectorEnvironment::reset() {
+	auto resetOne = [this](const size_t index)
+	{
+		Physics::PhysicsWorld* previousWorld = Physics::PhysicsEngine::setCurrentWorld(&m_environments[index].physicsWorld);
+		resetEnvironment(index);
+		writeObservation(index);
+		Physics::PhysicsEngine::setCurrentWorld(previousWorld);
+	};
+
+	if (m_threadPool) {
+		m_threadPool->parallelFor(m_environments.size(), resetOne);
+	}
+	else {
+		for (size_t currentIndex = 0; currentIndex < m_environments.size(); ++currentIndex) {
+			resetOne(currentIndex);
+		}
+	}
+	std::fill(m_rewards.begin(), m_rewards.end(), 0.f);
+	std::fill(m_dones.begin(), m_dones.end(), 0);
+}
+
+void VectorEnvironment::step(const Agent::Action* actions) {
+	auto stepOne = [this, actions](const size_t index)
+	{
+		stepEnvironment(index, actions + index * Agent::MAX_PLAYERS);
+	};
+
+	if (m_threadPool) {
+		m_threadPool->parallelFor(m_environments.size(), stepOne);
+	}
+	else {
+		for (size_t currentIndex = 0; currentIndex < m_environments.size(); ++currentIndex) {
+			stepOne(currentIndex);
+		}
+	}
+}
+
+void VectorEnvironment::setObservationEncoding(const bool isEnabled) {
+	if (!isEnabled || m_environments.empty()) {
+		m_encodedObservations.clear();
+		m_encodedObservations.shrink_to_fit();
+		m_encodedObservationSize = 0;
+		return;
+	}
+
+	// every environment plays the same level
+	m_encodedObservationSize = m_environments[0].level->getObservationEncoder().getSize();
+	m_encodedObservations.assign(m_environments.size() * m_encodedObservationSize, 0);
+	for (size_t currentIndex = 0; currentIndex < m_environments.size(); ++currentIndex) {
+		m_environments[currentIndex].isEncodingCurrent = false;
+		writeObservation(currentIndex);
+	}
+}
+
+void VectorEnvironment::resetEnvironment(const size_t index) {
+	Environment& environment = m_environments[index];
+	auto level = std::make_shared<Level>(ResourceManager::getLevels()[m_levelIndex], m_eGameMode);
+	// the steps already run on every worker, and they must not depend on how fast the machine is
+	level->setAIBudget(0);
+	level->setAIThreadPool(nullptr);
+	Physics::PhysicsEngine::setCurrentLevel(level);
+	environment.level = std::move(level);
+	environment.destroyedEnemyTanks = 0;
+	environment.episodeSteps = 0;
+	environment.isEncodingCurrent = false;
+}
+
+void VectorEnvironment::stepEnvironment(const size_t index, const Agent::Action* actions) {
+	Environment& environment = m_environments[index];
+	Physics::PhysicsWorld* previousWorld = Physics::PhysicsEngine::setCurrentWorld(&environment.physicsWorld);
+
+	Level& level = *environment.level;
+	for (size_t currentPlayer = 0; currentPlayer < Agent::MAX_PLAYERS; ++currentPlayer) {
+		const Agent::Action& action = actions[currentPlayer];
+		level.applyPlayerAction(currentPlayer, glm::ivec2(action.directionX, action.directionY), action.fire != 0);
+	}
+	level.update(STEP_TIME);
+	++environment.episodeSteps;
+
+	// the players share the reward, the game does not track who destroyed a tank
+	const float reward = static_cast<float>(level.getDestroyedEnemyTanks() - environment.destroyedEnemyTanks);
+	environment.destroyedEnemyTanks = level.getDestroyedEnemyTanks();
+	std::fill_n(m_rewards.begin() + index * Agent::MAX_PLAYERS, Agent::MAX_PLAYERS, reward);
+
+	const bool isDone = level.isCleared() || (m_maxEpisodeSteps > 0 && environment.episodeSteps >= m_maxEpisodeSteps);
+	m_dones[index] = isDone;
+	if (isDone) {
+		resetEnvironment(index);
+	}
+	writeObservation(index);
+
+	Physics::PhysicsEngine::setCurrentWorld(previousWorld);
+}
+
+void VectorEnvironment::writeObservation(const size_t index) {
+	Environment& environment = m_environments[index];
+	Level& level = *environment.level;
+	level.captureWorldState();
+	const WorldState* worldState = level.getWorldState();
+	m_isObservationValid[index] = worldState != nullptr;
+	if (worldState) {
+		m_observations[index] = *worldState;
+	}
+	else {
+		std::memset(&m_observations[index], 0, sizeof(WorldState));
+	}
+
+	if (m_encodedObservationSize > 0) {
+		level.encodeObservation(m_encodedObservations.data() + index * m_encodedObservationSize, environment.isEncodingCurrent);
+		environment.isEncodingCurrent = true;
+	}
+}
\ No newline at end of file
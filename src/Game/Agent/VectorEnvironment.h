@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+#include "AgentProtocol.h"
+#include "../Game.h"
+#include "../../Physics/PhysicsEngine.h"
+
+class Level;
+class ThreadPool;
+
+// Independent copies of a level stepped together, for training agents in process.
+// Every environment has its own physics world, so the environments are stepped side by side
+// on the thread pool; nothing is rendered, only the resources have to be loaded.
+// The outputs of a step are written into buffers allocated once, indexed by environment.
+class VectorEnvironment {
+public:
+	// simulated time of a step (ms), the same tick an attached agent steps the game with
+	static constexpr double STEP_TIME = Game::FIXED_TICK;
+
+	// maxEpisodeSteps ends an episode that runs that long, 0 lets it run until the level is cleared;
+	// without a thread pool the environments are stepped on the calling thread
+	VectorEnvironment(const size_t environmentsCount, const size_t levelIndex, const Game::EGameMode eGameMode,
+					  const uint64_t maxEpisodeSteps = 0, ThreadPool* threadPool = nullptr);
+	~VectorEnvironment();
+
+	VectorEnvironment(const VectorEnvironment&) = delete;
+	VectorEnvironment& operator = (const VectorEnvironment&) = delete;
+
+	// restarts every environment and writes their first observations
+	void reset();
+	// actions[environment * Agent::MAX_PLAYERS + player] are applied, then every environment advances one step;
+	// a finished environment restarts at once, its observation is the first one of the next episode
+	void step(const Agent::Action* actions);
+
+	size_t getEnvironmentsCount() const { return m_environments.size(); }
+	const WorldState* getObservations() const { return m_observations.data(); }
+	// 0 where the level is larger than a world state can hold, the observation is left empty
+	const uint8_t* getObservationsValidity() const { return m_isObservationValid.data(); }
+	// rewards[environment * Agent::MAX_PLAYERS + player], enemy tanks destroyed during the step
+	const float* getRewards() const { return m_rewards.data(); }
+	const uint8_t* getDones() const { return m_dones.data(); }
+
+	// the environments also write their planes of the observation encoder, one encoding after another
+	void setObservationEncoding(const bool isEnabled);
+	const uint8_t* getEncodedObservations() const { return m_encodedObservations.data(); }
+	size_t getEncodedObservationSize() const { return m_encodedObservationSize; }
+
+private:
+	struct Environment {
+		Physics::PhysicsWorld physicsWorld;
+		std::shared_ptr<Level> level;
+		size_t destroyedEnemyTanks = 0;
+		uint64_t episodeSteps = 0;
+		// the encoding in the buffer is of the current level, only changes have to be written
+		bool isEncodingCurrent = false;
+	};
+
+	void resetEnvironment(const size_t index);
+	void stepEnvironment(const size_t index, const Agent::Action* actions);
+	void writeObservation(const size_t index);
+
+	std::vector<Environment> m_environments;
+	size_t m_levelIndex;
+	Game::EGameMode m_eGameMode;
+	uint64_t m_maxEpisodeSteps;
+	ThreadPool* m_threadPool;
+
+	std::vector<WorldState> m_observations;
+	std::vector<uint8_t> m_isObservationValid;
+	std::vector<float> m_rewards;
+	std::vector<uint8_t> m_dones;
+	std::vector<uint8_t> m_encodedObservations;
+	size_t m_encodedObservationSize;
+};
\ No newline at end of file
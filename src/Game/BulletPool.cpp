@@ -0,0 +1,104 @@
+#include "BulletPool.h"
+
+#include "GameObjects/Bullet.h"
+#include "../Physics/PhysicsEngine.h"
+#include "../System/MonotonicArena.h"
+#include "../System/Snapshot.h"
+
+BulletPool::BulletPool(const size_t capacity,
+					   const double velocity,
+					   const glm::vec2& size,
+					   const glm::vec2& explosionSize,
+					   const float layer,
+					   TimerWheel* timerWheel,
+					   RenderEngine::AnimationSystem* animationSystem,
+					   DynamicEntityWorld* world,
+					   MonotonicArena* arena)
+{
+	m_bullets.reserve(capacity);
+	m_freeBullets.reserve(capacity);
+	m_activeBullets.reserve(capacity);
+	for (size_t currentBullet = 0; currentBullet < capacity; ++currentBullet) {
+		m_bullets.emplace_back(arena->makeShared<Bullet>(velocity, glm::vec2(0), size, explosionSize, layer, timerWheel, animationSystem, world));
+		m_freeBullets.push_back(capacity - currentBullet - 1);
+	}
+}
+
+BulletPool::~BulletPool() {
+
+}
+
+Bullet* BulletPool::fire(const ECS::Entity& shooter, const glm::vec2& position, const glm::vec2& direction) {
+	if (m_freeBullets.empty()) {
+		return nullptr;
+	}
+
+	const size_t bulletIndex = m_freeBullets.back();
+	m_freeBullets.pop_back();
+	m_activeBullets.push_back(bulletIndex);
+
+	const auto& bullet = m_bullets[bulletIndex];
+	bullet->fire(shooter, position, direction);
+	Physics::PhysicsEngine::addDynamicGameObject(bullet);
+	return bullet.get();
+}
+
+void BulletPool::tick(const IGameObject::ETickPhase eTickPhase, const double delta) {
+	for (const size_t bulletIndex : m_activeBullets) {
+		m_bullets[bulletIndex]->tick(eTickPhase, delta);
+	}
+}
+
+void BulletPool::release(const size_t activeIndex) {
+	const size_t bulletIndex = m_activeBullets[activeIndex];
+	m_activeBullets[activeIndex] = m_activeBullets.back();
+	m_activeBullets.pop_back();
+
+	Bullet& bullet = *m_bullets[bulletIndex];
+	Physics::PhysicsEngine::removeDynamicGameObject(bullet);
+	m_freeBullets.push_back(bulletIndex);
+}
+
+void BulletPool::releaseExpired() {
+	for (size_t activeIndex = 0; activeIndex < m_activeBullets.size();) {
+		if (!m_bullets[m_activeBullets[activeIndex]]->isActive()) {
+			release(activeIndex);
+		}
+		else {
+			++activeIndex;
+		}
+	}
+}
+
+
+void BulletPool::saveState(SnapshotWriter& writer) const {
+	writer.writeVector(m_freeBullets);
+	writer.writeVector(m_activeBullets);
+}
+
+bool BulletPool::readState(SnapshotReader& reader, SavedState& state) const {
+	if (!reader.readVector(state.freeBullets) || !reader.readVector(state.activeBullets)) {
+		return false;
+	}
+	if (state.freeBullets.size() + state.activeBullets.size() != m_bullets.size()) {
+		return false;
+	}
+	std::vector<bool> isListed(m_bullets.size(), false);
+	for (const auto* bulletIndices : { &state.freeBullets, &state.activeBullets }) {
+		for (const size_t bulletIndex : *bulletIndices) {
+			if (bulletIndex >= m_bullets.size() || isListed[bulletIndex]) {
+				return false;
+			}
+			isListed[bulletIndex] = true;
+		}
+	}
+	return true;
+}
+
+void BulletPool::restoreState(const SavedState& state) {
+	m_freeBullets = state.freeBullets;
+	m_activeBullets = state.activeBullets;
+	for (const auto& currentBullet : m_bullets) {
+		currentBullet->restoreState();
+	}
+}
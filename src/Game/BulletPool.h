@@ -0,0 +1,63 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <glm/vec2.hpp>
+
+#include "GameObjects/IGameObject.h"
+#include "ECS/EntityWorld.h"
+
+class Bullet;
+class TimerWheel;
+class DynamicEntityWorld;
+class MonotonicArena;
+class SnapshotWriter;
+class SnapshotReader;
+
+namespace RenderEngine {
+	class AnimationSystem;
+}
+
+class BulletPool {
+public:
+	BulletPool(const size_t capacity,
+		const double velocity,
+		const glm::vec2& size,
+		const glm::vec2& explosionSize,
+		const float layer,
+		TimerWheel* timerWheel,
+		RenderEngine::AnimationSystem* animationSystem,
+		DynamicEntityWorld* world,
+		MonotonicArena* arena);
+	~BulletPool();
+
+	BulletPool(const BulletPool&) = delete;
+	BulletPool& operator = (const BulletPool&) = delete;
+
+	Bullet* fire(const ECS::Entity& shooter, const glm::vec2& position, const glm::vec2& direction);
+	void tick(const IGameObject::ETickPhase eTickPhase, const double delta);
+	void releaseExpired();
+
+	size_t getCapacity() const { return m_bullets.size(); }
+	size_t getActiveCount() const { return m_activeBullets.size(); }
+	Bullet& getActiveBullet(const size_t activeIndex) const { return *m_bullets[m_activeBullets[activeIndex]]; }
+	const std::shared_ptr<Bullet>& getBullet(const size_t bulletIndex) const { return m_bullets[bulletIndex]; }
+
+	// which bullets are in use; the bullets are restored with the entity world and the timers,
+	// the owners of the bullets are restored by the level
+	struct SavedState {
+		std::vector<size_t> freeBullets;
+		std::vector<size_t> activeBullets;
+	};
+	void saveState(SnapshotWriter& writer) const;
+	// every bullet of the pool has to be either free or active once, the pool is not changed
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	void restoreState(const SavedState& state);
+
+private:
+	void release(const size_t activeIndex);
+
+	std::vector<std::shared_ptr<Bullet>> m_bullets;
+	std::vector<size_t> m_freeBullets;
+	std::vector<size_t> m_activeBullets;
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/vec2.hpp>
+#include <vector>
+
+#include "../../Physics/PhysicsEngine.h"
+
+class Bullet;
+class BulletPool;
+class AIComponent;
+
+// components shared by the dynamic entities, the type specific ones are declared with their types
+namespace ECS {
+
+	struct Transform {
+		glm::vec2 position;
+		glm::vec2 targetPosition;
+		glm::vec2 size;
+		float layer;
+	};
+
+	struct Kinematics {
+		glm::vec2 direction;
+		double velocity;
+		double maxVelocity;
+	};
+
+	struct Collision {
+		Physics::ColliderList colliders;
+	};
+
+	struct Weapon {
+		BulletPool* bulletPool;
+		// bullets of the entity that may still be in flight
+		std::vector<Bullet*> bullets;
+		size_t maxBullets;
+	};
+
+	// owned by the handle of the entity
+	struct AIController {
+		AIComponent* component;
+	};
+}
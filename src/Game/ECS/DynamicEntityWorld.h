@@ -0,0 +1,96 @@
+#pragma once
+
+#include "EntityWorld.h"
+#include "Components.h"
+#include "../GameObjects/Tank.h"
+#include "../GameObjects/Bullet.h"
+
+typedef ECS::Archetype<ECS::Transform,
+					   ECS::Kinematics,
+					   ECS::Collision,
+					   ECS::Weapon,
+					   ECS::AIController,
+					   Tank::State,
+					   Tank::Animations,
+					   Tank::Timers> TankArchetype;
+
+typedef ECS::Archetype<ECS::Transform,
+					   ECS::Kinematics,
+					   ECS::Collision,
+					   Bullet::State,
+					   Bullet::Explosion> BulletArchetype;
+
+// tanks and bullets of a level, owned by the level and outliving every handle into it
+class DynamicEntityWorld : public ECS::World<TankArchetype, BulletArchetype> {
+public:
+	DynamicEntityWorld(const size_t tanksCapacity, const size_t bulletsCapacity) {
+		getArchetype<TankArchetype>().reserve(tanksCapacity);
+		getArchetype<BulletArchetype>().reserve(bulletsCapacity);
+	}
+
+	// components without pointers; the world restoring them has to have the same entities,
+	// the tanks and bullets rebuild the rest themselves
+	struct SavedState {
+		SavedEntities entities;
+		std::tuple<std::vector<ECS::Transform>, std::vector<ECS::Kinematics>, std::vector<Tank::State>, std::vector<Tank::Animations>, std::vector<Tank::Timers>> tanks;
+		std::tuple<std::vector<ECS::Transform>, std::vector<ECS::Kinematics>, std::vector<Bullet::State>, std::vector<Bullet::Explosion>> bullets;
+	};
+
+	void saveState(SnapshotWriter& writer) const {
+		saveEntities(writer);
+		getArchetype<TankArchetype>().saveColumns<ECS::Transform, ECS::Kinematics, Tank::State, Tank::Animations, Tank::Timers>(writer);
+		getArchetype<BulletArchetype>().saveColumns<ECS::Transform, ECS::Kinematics, Bullet::State, Bullet::Explosion>(writer);
+	}
+
+	// the enums and bools are checked because they index arrays, the animations against the state read for the animation system;
+	// the world is not changed
+	bool readState(SnapshotReader& reader, SavedState& state, const RenderEngine::AnimationSystem::SavedState& animations) const {
+		if (!readEntities(reader, state.entities)
+			|| !getArchetype<TankArchetype>().readColumns(reader, state.tanks)
+			|| !getArchetype<BulletArchetype>().readColumns(reader, state.bullets)) {
+			return false;
+		}
+
+		// orientations of tanks are plain ints
+		const auto isOrientation = [](const Tank::EOrientation eOrientation)
+		{
+			return static_cast<uint32_t>(eOrientation) <= static_cast<uint32_t>(Tank::EOrientation::Right);
+		};
+		const auto& tankStates = std::get<std::vector<Tank::State>>(state.tanks);
+		const auto& tankAnimations = std::get<std::vector<Tank::Animations>>(state.tanks);
+		for (size_t currentRow = 0; currentRow < tankStates.size(); ++currentRow) {
+			const Tank::State& tankState = tankStates[currentRow];
+			if (static_cast<size_t>(tankState.eType) >= Tank::TANK_TYPES_COUNT || !isOrientation(tankState.eOrientation) || !isOrientation(tankState.eSpawnOrientation)
+				|| !SnapshotReader::isBool(tankState.isActive) || !SnapshotReader::isBool(tankState.isSpawning) || !SnapshotReader::isBool(tankState.hasShield)
+				|| !SnapshotReader::isBool(tankState.bShieldOnSpawn) || !SnapshotReader::isBool(tankState.isDestroyed)) {
+				return false;
+			}
+			const Tank::Animations& tankAnimation = tankAnimations[currentRow];
+			for (const auto& currentAnimation : tankAnimation.movement) {
+				if (!animations.isValid(currentAnimation)) {
+					return false;
+				}
+			}
+			if (!animations.isValid(tankAnimation.respawn) || !animations.isValid(tankAnimation.shield)) {
+				return false;
+			}
+		}
+
+		const auto& bulletStates = std::get<std::vector<Bullet::State>>(state.bullets);
+		const auto& bulletExplosions = std::get<std::vector<Bullet::Explosion>>(state.bullets);
+		for (size_t currentRow = 0; currentRow < bulletStates.size(); ++currentRow) {
+			const Bullet::State& bulletState = bulletStates[currentRow];
+			if (bulletState.eOrientation > Bullet::EOrientation::Right || !SnapshotReader::isBool(bulletState.isActive) || !SnapshotReader::isBool(bulletState.isExplosion)
+				|| !animations.isValid(bulletExplosions[currentRow].animation)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void restoreState(const SavedState& state) {
+		restoreEntities(state.entities);
+		getArchetype<TankArchetype>().restoreColumns(state.tanks);
+		getArchetype<BulletArchetype>().restoreColumns(state.bullets);
+	}
+};
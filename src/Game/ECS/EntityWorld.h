@@ -0,0 +1,294 @@
+#pragma once
+
+#include <vector>
+#include <tuple>
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <limits>
+#include <utility>
+#include <type_traits>
+
+#include "../../System/Snapshot.h"
+
+namespace ECS {
+
+	struct Entity {
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+
+		bool operator == (const Entity& other) const { return index == other.index && generation == other.generation; }
+		bool operator != (const Entity& other) const { return !(*this == other); }
+	};
+
+	// Entities with the same set of components, every component type in its own contiguous array.
+	// Removing an entity moves the last row into its place, so rows stay packed.
+	template <class... Components>
+	class Archetype {
+	public:
+		template <class Component>
+		static constexpr bool has() { return (std::is_same_v<Component, Components> || ...); }
+
+		template <class Component>
+		std::vector<Component>& column() { return std::get<std::vector<Component>>(m_columns); }
+
+		template <class Component>
+		const std::vector<Component>& column() const { return std::get<std::vector<Component>>(m_columns); }
+
+		size_t size() const { return m_entities.size(); }
+		uint32_t getEntityIndex(const size_t row) const { return m_entities[row]; }
+
+		void reserve(const size_t capacity) {
+			(column<Components>().reserve(capacity), ...);
+			m_entities.reserve(capacity);
+		}
+
+		size_t add(const uint32_t entityIndex, Components&&... components) {
+			(column<Components>().push_back(std::move(components)), ...);
+			m_entities.push_back(entityIndex);
+			return m_entities.size() - 1;
+		}
+
+		// returns the entity moved into the row, or INVALID_INDEX if the last row was removed
+		uint32_t remove(const size_t row) {
+			const size_t lastRow = m_entities.size() - 1;
+			uint32_t movedEntity = Entity::INVALID_INDEX;
+			if (row != lastRow) {
+				(moveRow<Components>(lastRow, row), ...);
+				m_entities[row] = m_entities[lastRow];
+				movedEntity = m_entities[row];
+			}
+			(column<Components>().pop_back(), ...);
+			m_entities.pop_back();
+			return movedEntity;
+		}
+
+		template <class... Selected, class Function>
+		void forEach(Function&& function) {
+			const size_t rowsCount = size();
+			auto columns = std::tie(column<Selected>()...);
+			for (size_t currentRow = 0; currentRow < rowsCount; ++currentRow) {
+				function(std::get<std::vector<Selected>&>(columns)[currentRow]...);
+			}
+		}
+
+		template <class... Selected, class Function>
+		void forEach(Function&& function) const {
+			const size_t rowsCount = size();
+			auto columns = std::tie(column<Selected>()...);
+			for (size_t currentRow = 0; currentRow < rowsCount; ++currentRow) {
+				function(std::get<const std::vector<Selected>&>(columns)[currentRow]...);
+			}
+		}
+
+		// rows of the selected components as raw memory, the entities of the archetype are not saved
+		template <class... Selected>
+		void saveColumns(SnapshotWriter& writer) const {
+			(writer.writeVector(column<Selected>()), ...);
+		}
+
+		// the archetype has to hold as many entities as when the columns were saved;
+		// the columns are read into copies, the archetype is not changed
+		template <class... Selected>
+		bool readColumns(SnapshotReader& reader, std::tuple<std::vector<Selected>...>& columns) const {
+			return ((std::get<std::vector<Selected>>(columns).resize(size()), reader.readArray(std::get<std::vector<Selected>>(columns).data(), size())) && ...);
+		}
+
+		template <class... Selected>
+		void restoreColumns(const std::tuple<std::vector<Selected>...>& columns) {
+			((column<Selected>() = std::get<std::vector<Selected>>(columns)), ...);
+		}
+
+	private:
+		template <class Component>
+		void moveRow(const size_t from, const size_t to) {
+			auto& components = column<Component>();
+			components[to] = std::move(components[from]);
+		}
+
+		std::tuple<std::vector<Components>...> m_columns;
+		std::vector<uint32_t> m_entities;
+	};
+
+	// Entities of a fixed set of archetypes. Entities are addressed through generational handles,
+	// systems iterate the component arrays of every archetype that has the components they need.
+	// References to components stay valid until an entity of the same archetype is created or destroyed.
+	template <class... Archetypes>
+	class World {
+	public:
+		template <class ArchetypeType>
+		static constexpr size_t getArchetypeIndex() {
+			size_t index = 0;
+			bool found = false;
+			((found = found || std::is_same_v<ArchetypeType, Archetypes>, index += found ? 0 : 1), ...);
+			return index;
+		}
+
+		template <class ArchetypeType>
+		ArchetypeType& getArchetype() { return std::get<ArchetypeType>(m_archetypes); }
+
+		template <class ArchetypeType>
+		const ArchetypeType& getArchetype() const { return std::get<ArchetypeType>(m_archetypes); }
+
+		template <class ArchetypeType, class... Components>
+		Entity create(Components&&... components) {
+			uint32_t index;
+			if (!m_freeEntities.empty()) {
+				index = m_freeEntities.back();
+				m_freeEntities.pop_back();
+			}
+			else {
+				index = static_cast<uint32_t>(m_locations.size());
+				m_locations.emplace_back();
+			}
+
+			Location& location = m_locations[index];
+			location.archetype = static_cast<uint8_t>(getArchetypeIndex<ArchetypeType>());
+			location.row = static_cast<uint32_t>(getArchetype<ArchetypeType>().add(index, std::forward<Components>(components)...));
+			location.isAlive = true;
+			return { index, location.generation };
+		}
+
+		void destroy(Entity& entity) {
+			if (isAlive(entity)) {
+				Location& location = m_locations[entity.index];
+				visitArchetype(location.archetype, [this, &location](auto& archetype)
+					{
+						const uint32_t movedEntity = archetype.remove(location.row);
+						if (movedEntity != Entity::INVALID_INDEX) {
+							m_locations[movedEntity].row = location.row;
+						}
+					}
+				);
+				location.isAlive = false;
+				++location.generation;
+				m_freeEntities.push_back(entity.index);
+			}
+			entity = Entity();
+		}
+
+		// starts a new life of an alive entity: the components stay, handles to the previous life stop matching
+		void renew(Entity& entity) {
+			if (isAlive(entity)) {
+				entity.generation = ++m_locations[entity.index].generation;
+			}
+		}
+
+		bool isAlive(const Entity& entity) const {
+			return entity.index < m_locations.size() && m_locations[entity.index].isAlive && m_locations[entity.index].generation == entity.generation;
+		}
+
+		template <class Component>
+		Component& get(const Entity& entity) {
+			assert(isAlive(entity));
+			const Location& location = m_locations[entity.index];
+			Component* component = nullptr;
+			visitArchetype(location.archetype, [&component, &location](auto& archetype)
+				{
+					if constexpr (std::decay_t<decltype(archetype)>::template has<Component>()) {
+						component = &archetype.template column<Component>()[location.row];
+					}
+				}
+			);
+			assert(component && "entity has no such component");
+			return *component;
+		}
+
+		template <class Component>
+		const Component& get(const Entity& entity) const {
+			return const_cast<World*>(this)->get<Component>(entity);
+		}
+
+		// calls function for every entity that has all selected components
+		template <class... Selected, class Function>
+		void forEach(Function&& function) {
+			(forEachIn<Archetypes, Selected...>(function), ...);
+		}
+
+		template <class... Selected, class Function>
+		void forEach(Function&& function) const {
+			(forEachIn<Archetypes, Selected...>(function), ...);
+		}
+
+		size_t getEntitiesCount() const { return m_locations.size() - m_freeEntities.size(); }
+		// current handle of the entity at the index
+		Entity getEntity(const uint32_t index) const { return { index, m_locations[index].generation }; }
+
+		// generations and rows of the entities, the world restoring them has to have created the same entities
+		struct SavedEntities;
+		void saveEntities(SnapshotWriter& writer) const {
+			writer.writeVector(m_locations);
+			writer.writeVector(m_freeEntities);
+		}
+
+		// only the generations can differ from the entities of this world, the world is not changed
+		bool readEntities(SnapshotReader& reader, SavedEntities& entities) const {
+			entities.locations.resize(m_locations.size());
+			entities.freeEntities.resize(m_freeEntities.size());
+			if (!reader.readArray(entities.locations.data(), entities.locations.size()) || !reader.readArray(entities.freeEntities.data(), entities.freeEntities.size())) {
+				return false;
+			}
+			for (size_t currentEntity = 0; currentEntity < m_locations.size(); ++currentEntity) {
+				const Location& location = m_locations[currentEntity];
+				const Location& savedLocation = entities.locations[currentEntity];
+				if (savedLocation.row != location.row || savedLocation.archetype != location.archetype
+					|| !SnapshotReader::isBool(savedLocation.isAlive) || savedLocation.isAlive != location.isAlive) {
+					return false;
+				}
+			}
+			return entities.freeEntities == m_freeEntities;
+		}
+
+		void restoreEntities(const SavedEntities& entities) {
+			for (size_t currentEntity = 0; currentEntity < m_locations.size(); ++currentEntity) {
+				m_locations[currentEntity].generation = entities.locations[currentEntity].generation;
+			}
+		}
+
+	private:
+		struct Location {
+			uint32_t generation = 0;
+			uint32_t row = 0;
+			uint8_t archetype = 0;
+			bool isAlive = false;
+		};
+
+		template <size_t Index = 0, class Function>
+		void visitArchetype(const size_t archetypeIndex, Function&& function) {
+			if constexpr (Index < sizeof...(Archetypes)) {
+				if (archetypeIndex == Index) {
+					function(std::get<Index>(m_archetypes));
+				}
+				else {
+					visitArchetype<Index + 1>(archetypeIndex, std::forward<Function>(function));
+				}
+			}
+		}
+
+		template <class ArchetypeType, class... Selected, class Function>
+		void forEachIn(Function& function) {
+			if constexpr ((ArchetypeType::template has<Selected>() && ...)) {
+				getArchetype<ArchetypeType>().template forEach<Selected...>(function);
+			}
+		}
+
+		template <class ArchetypeType, class... Selected, class Function>
+		void forEachIn(Function& function) const {
+			if constexpr ((ArchetypeType::template has<Selected>() && ...)) {
+				getArchetype<ArchetypeType>().template forEach<Selected...>(function);
+			}
+		}
+
+		std::tuple<Archetypes...> m_archetypes;
+		std::vector<Location> m_locations;
+		std::vector<uint32_t> m_freeEntities;
+	};
+
+	template <class... Archetypes>
+	struct World<Archetypes...>::SavedEntities {
+		std::vector<Location> locations;
+		std::vector<uint32_t> freeEntities;
+	};
+}
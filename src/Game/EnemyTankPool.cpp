@@ -0,0 +1,127 @@
+#include "EnemyTankPool.h"
+
+#include "../Physics/PhysicsEngine.h"
+#include "../System/MonotonicArena.h"
+#include "../Renderer/AnimationSystem.h"
+#include "../System/Snapshot.h"
+
+EnemyTankPool::EnemyTankPool(const size_t capacity,
+							 const double maxVelocity,
+							 const glm::vec2& size,
+							 const float layer,
+							 BulletPool* bulletPool,
+							 TimerWheel* timerWheel,
+							 RenderEngine::AnimationSystem* animationSystem,
+							 DynamicEntityWorld* world,
+							 MonotonicArena* arena)
+{
+	// frames of every enemy type are registered up front, recycling a tank as another type only switches tables
+	for (size_t currentType = static_cast<size_t>(Tank::ETankType::EnemyWhite_type1); currentType < Tank::TANK_TYPES_COUNT; ++currentType) {
+		for (const auto& sprite : Tank::getVisuals(static_cast<Tank::ETankType>(currentType)).sprites) {
+			animationSystem->preload(sprite);
+		}
+	}
+
+	m_tanks.reserve(capacity);
+	m_freeTanks.reserve(capacity);
+	m_activeTanks.reserve(capacity);
+	for (size_t currentTank = 0; currentTank < capacity; ++currentTank) {
+		m_tanks.emplace_back(arena->makeShared<Tank>(Tank::ETankType::EnemyWhite_type1, true, false, Tank::EOrientation::Bottom, maxVelocity, glm::vec2(0), size, layer, bulletPool, timerWheel, animationSystem, world));
+		m_tanks.back()->despawn();
+		m_freeTanks.push_back(capacity - currentTank - 1);
+	}
+}
+
+EnemyTankPool::~EnemyTankPool() {
+
+}
+
+EnemyTankPool::TankHandle EnemyTankPool::spawn(const Tank::ETankType eType, const glm::vec2& spawnPoint) {
+	if (m_freeTanks.empty()) {
+		return TankHandle();
+	}
+
+	const size_t tankIndex = m_freeTanks.back();
+	m_freeTanks.pop_back();
+	const TankHandle handle = m_activeTanks.insert(tankIndex);
+
+	const auto& tank = m_tanks[tankIndex];
+	tank->reset(eType, spawnPoint);
+	Physics::PhysicsEngine::addDynamicGameObject(tank);
+	return handle;
+}
+
+Tank* EnemyTankPool::getTank(const TankHandle& handle) const {
+	const size_t* tankIndex = m_activeTanks.get(handle);
+	return tankIndex ? m_tanks[*tankIndex].get() : nullptr;
+}
+
+size_t EnemyTankPool::tick(const IGameObject::ETickPhase eTickPhase, const double delta) {
+	size_t tickedTanks = 0;
+	for (const size_t tankIndex : m_activeTanks) {
+		Tank& tank = *m_tanks[tankIndex];
+		if (!tank.ticksIn(eTickPhase)) {
+			continue;
+		}
+		const double step = tank.getSimulationDelta(delta);
+		if (step > 0) {
+			tank.tick(eTickPhase, step);
+			++tickedTanks;
+		}
+	}
+	return tickedTanks;
+}
+
+void EnemyTankPool::release(const size_t activeIndex) {
+	const size_t tankIndex = m_activeTanks[activeIndex];
+	m_activeTanks.eraseAt(activeIndex);
+
+	Tank& tank = *m_tanks[tankIndex];
+	Physics::PhysicsEngine::removeDynamicGameObject(tank);
+	tank.despawn();
+	m_freeTanks.push_back(tankIndex);
+}
+
+size_t EnemyTankPool::releaseDestroyed() {
+	size_t releasedTanks = 0;
+	for (size_t activeIndex = 0; activeIndex < m_activeTanks.size();) {
+		if (m_tanks[m_activeTanks[activeIndex]]->isDestroyed()) {
+			release(activeIndex);
+			++releasedTanks;
+		}
+		else {
+			++activeIndex;
+		}
+	}
+	return releasedTanks;
+}
+
+
+void EnemyTankPool::saveState(SnapshotWriter& writer) const {
+	writer.writeVector(m_freeTanks);
+	m_activeTanks.saveState(writer);
+}
+
+bool EnemyTankPool::readState(SnapshotReader& reader, SavedState& state) const {
+	if (!reader.readVector(state.freeTanks) || !m_activeTanks.readState(reader, state.activeTanks)) {
+		return false;
+	}
+	if (state.freeTanks.size() + state.activeTanks.values.size() != m_tanks.size()) {
+		return false;
+	}
+	std::vector<bool> isListed(m_tanks.size(), false);
+	for (const auto* tankIndices : { &state.freeTanks, &state.activeTanks.values }) {
+		for (const size_t tankIndex : *tankIndices) {
+			if (tankIndex >= m_tanks.size() || isListed[tankIndex]) {
+				return false;
+			}
+			isListed[tankIndex] = true;
+		}
+	}
+	return true;
+}
+
+void EnemyTankPool::restoreState(const SavedState& state) {
+	m_freeTanks = state.freeTanks;
+	m_activeTanks.restoreState(state.activeTanks);
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <glm/vec2.hpp>
+
+#include "GameObjects/IGameObject.h"
+#include "GameObjects/Tank.h"
+#include "../System/SlotMap.h"
+
+class BulletPool;
+class TimerWheel;
+class DynamicEntityWorld;
+class MonotonicArena;
+class SnapshotWriter;
+class SnapshotReader;
+
+namespace RenderEngine {
+	class AnimationSystem;
+}
+
+// Enemy tanks constructed when the level loads and recycled when they are destroyed,
+// so spawning a wave does no allocation or resource lookups.
+class EnemyTankPool {
+public:
+	// stays safe to use after the tank is destroyed, getTank returns nullptr for it from then on
+	typedef SlotMap<size_t>::Handle TankHandle;
+
+	EnemyTankPool(const size_t capacity,
+		const double maxVelocity,
+		const glm::vec2& size,
+		const float layer,
+		BulletPool* bulletPool,
+		TimerWheel* timerWheel,
+		RenderEngine::AnimationSystem* animationSystem,
+		DynamicEntityWorld* world,
+		MonotonicArena* arena);
+	~EnemyTankPool();
+
+	EnemyTankPool(const EnemyTankPool&) = delete;
+	EnemyTankPool& operator = (const EnemyTankPool&) = delete;
+
+	// returns an invalid handle if every tank of the pool is on the level
+	TankHandle spawn(const Tank::ETankType eType, const glm::vec2& spawnPoint);
+	Tank* getTank(const TankHandle& handle) const;
+	bool isAlive(const TankHandle& handle) const { return m_activeTanks.contains(handle); }
+	// returns the number of tanks that were ticked
+	size_t tick(const IGameObject::ETickPhase eTickPhase, const double delta);
+	// returns the number of destroyed tanks put back into the pool
+	size_t releaseDestroyed();
+
+	size_t getCapacity() const { return m_tanks.size(); }
+	size_t getActiveCount() const { return m_activeTanks.size(); }
+	// active tanks are iterated densely, in the order of their spawns and releases
+	Tank& getActiveTank(const size_t activeIndex) const { return *m_tanks[m_activeTanks[activeIndex]]; }
+	TankHandle getActiveHandle(const size_t activeIndex) const { return m_activeTanks.getHandle(activeIndex); }
+	const std::shared_ptr<Tank>& getTankAt(const size_t tankIndex) const { return m_tanks[tankIndex]; }
+
+	// which tanks are on the level, the tanks themselves are restored by the level
+	struct SavedState {
+		std::vector<size_t> freeTanks;
+		SlotMap<size_t>::SavedState activeTanks;
+	};
+	void saveState(SnapshotWriter& writer) const;
+	// every tank of the pool has to be either free or active once, the pool is not changed
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	void restoreState(const SavedState& state);
+
+private:
+	void release(const size_t activeIndex);
+
+	std::vector<std::shared_ptr<Tank>> m_tanks;
+	std::vector<size_t> m_freeTanks;
+	// indices into m_tanks
+	SlotMap<size_t> m_activeTanks;
+};
@@ -0,0 +1,245 @@
+#include "FlowField.h"
+
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <glm/common.hpp>
+
+static const std::array<glm::ivec2, 4> NEIGHBOR_OFFSETS = {
+	glm::ivec2(0, 1),
+	glm::ivec2(0, -1),
+	glm::ivec2(-1, 0),
+	glm::ivec2(1, 0)
+};
+
+NavigationGrid::NavigationGrid()
+	: m_widthCells(0)
+	, m_heightCells(0)
+	, m_widthNodes(0)
+	, m_heightNodes(0)
+	, m_origin(0)
+	, m_dirtyMin(0, 0)
+	, m_dirtyMax(0, 0)
+{
+}
+
+void NavigationGrid::reset(const size_t widthCells, const size_t heightCells, const glm::vec2& origin) {
+	m_widthCells = widthCells;
+	m_heightCells = heightCells;
+	m_widthNodes = widthCells >= TANK_CELLS ? widthCells - TANK_CELLS + 1 : 0;
+	m_heightNodes = heightCells >= TANK_CELLS ? heightCells - TANK_CELLS + 1 : 0;
+	m_origin = origin;
+	m_cellCosts.assign(m_widthCells * m_heightCells, 0);
+	m_nodeCosts.assign(m_widthNodes * m_heightNodes, 0);
+	m_dirtyMin = glm::ivec2(static_cast<int>(m_widthCells), static_cast<int>(m_heightCells));
+	m_dirtyMax = glm::ivec2(0, 0);
+}
+
+void NavigationGrid::getCells(const Physics::AABB& area, glm::ivec2& min, glm::ivec2& max) const {
+	const glm::vec2 bottomLeft = (area.bottomLeft - m_origin) / static_cast<float>(CELL_SIZE);
+	const glm::vec2 topRight = (area.topRight - m_origin) / static_cast<float>(CELL_SIZE);
+	min.x = std::clamp(static_cast<int>(std::floor(bottomLeft.x)), 0, static_cast<int>(m_widthCells));
+	min.y = std::clamp(static_cast<int>(std::floor(bottomLeft.y)), 0, static_cast<int>(m_heightCells));
+	max.x = std::clamp(static_cast<int>(std::ceil(topRight.x)), 0, static_cast<int>(m_widthCells));
+	max.y = std::clamp(static_cast<int>(std::ceil(topRight.y)), 0, static_cast<int>(m_heightCells));
+}
+
+void NavigationGrid::setArea(const Physics::AABB& area, const uint16_t cost) {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	getCells(area, min, max);
+	for (int currentY = min.y; currentY < max.y; ++currentY) {
+		for (int currentX = min.x; currentX < max.x; ++currentX) {
+			m_cellCosts[currentY * m_widthCells + currentX] = cost;
+		}
+	}
+	if (min.x < max.x && min.y < max.y) {
+		m_dirtyMin = glm::min(m_dirtyMin, min);
+		m_dirtyMax = glm::max(m_dirtyMax, max);
+	}
+}
+
+uint16_t NavigationGrid::calculateNodeCost(const glm::ivec2& node) const {
+	uint32_t cost = 0;
+	for (size_t currentY = node.y; currentY < node.y + TANK_CELLS; ++currentY) {
+		for (size_t currentX = node.x; currentX < node.x + TANK_CELLS; ++currentX) {
+			const uint16_t cellCost = m_cellCosts[currentY * m_widthCells + currentX];
+			if (cellCost == BLOCKED) {
+				return BLOCKED;
+			}
+			cost += cellCost;
+		}
+	}
+	return static_cast<uint16_t>(std::min<uint32_t>(cost, BLOCKED - 1));
+}
+
+bool NavigationGrid::commitChanges(std::vector<uint32_t>& changedNodes) {
+	changedNodes.clear();
+	bool onlyDecreased = true;
+
+	// every node whose footprint overlaps a changed cell
+	const int startX = std::max(m_dirtyMin.x - static_cast<int>(TANK_CELLS) + 1, 0);
+	const int startY = std::max(m_dirtyMin.y - static_cast<int>(TANK_CELLS) + 1, 0);
+	const int endX = std::min(m_dirtyMax.x, static_cast<int>(m_widthNodes));
+	const int endY = std::min(m_dirtyMax.y, static_cast<int>(m_heightNodes));
+	for (int currentY = startY; currentY < endY; ++currentY) {
+		for (int currentX = startX; currentX < endX; ++currentX) {
+			const uint32_t node = getNodeIndex(glm::ivec2(currentX, currentY));
+			const uint16_t cost = calculateNodeCost(glm::ivec2(currentX, currentY));
+			if (cost != m_nodeCosts[node]) {
+				onlyDecreased = onlyDecreased && cost < m_nodeCosts[node];
+				m_nodeCosts[node] = cost;
+				changedNodes.push_back(node);
+			}
+		}
+	}
+
+	m_dirtyMin = glm::ivec2(static_cast<int>(m_widthCells), static_cast<int>(m_heightCells));
+	m_dirtyMax = glm::ivec2(0, 0);
+	return onlyDecreased;
+}
+
+glm::ivec2 NavigationGrid::getNode(const glm::vec2& position) const {
+	const glm::vec2 node = (position - m_origin) / static_cast<float>(CELL_SIZE);
+	return glm::ivec2(std::clamp(static_cast<int>(std::lround(node.x)), 0, static_cast<int>(m_widthNodes) - 1),
+					  std::clamp(static_cast<int>(std::lround(node.y)), 0, static_cast<int>(m_heightNodes) - 1));
+}
+
+FlowField::FlowField(const NavigationGrid* grid)
+	: m_grid(grid)
+	, m_goalMin(0, 0)
+	, m_goalMax(0, 0)
+	, m_hasGoal(false)
+{
+}
+
+void FlowField::setGoal(const glm::ivec2& goalMin, const glm::ivec2& goalMax) {
+	m_goalMin = goalMin;
+	m_goalMax = goalMax;
+	m_hasGoal = true;
+	rebuild();
+}
+
+void FlowField::clearGoal() {
+	m_hasGoal = false;
+	m_distances.assign(m_grid->getNodesCount(), UNREACHABLE);
+}
+
+bool FlowField::isGoal(const glm::ivec2& node) const {
+	const int tankCells = static_cast<int>(NavigationGrid::TANK_CELLS);
+	return node.x - 1 < m_goalMax.x && node.x + tankCells + 1 > m_goalMin.x
+		&& node.y - 1 < m_goalMax.y && node.y + tankCells + 1 > m_goalMin.y;
+}
+
+void FlowField::rebuild() {
+	m_distances.assign(m_grid->getNodesCount(), UNREACHABLE);
+	m_queue.clear();
+	if (!m_hasGoal) {
+		return;
+	}
+
+	for (uint32_t currentNode = 0; currentNode < m_distances.size(); ++currentNode) {
+		if (m_grid->getNodeCost(currentNode) != NavigationGrid::BLOCKED && isGoal(m_grid->getNodeCoords(currentNode))) {
+			m_distances[currentNode] = 0;
+			m_queue.emplace_back(0, currentNode);
+		}
+	}
+	std::make_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+	propagate();
+}
+
+void FlowField::onCostsDecreased(const std::vector<uint32_t>& changedNodes) {
+	if (!m_hasGoal) {
+		return;
+	}
+
+	const glm::ivec2 size(m_grid->getWidthNodes(), m_grid->getHeightNodes());
+	for (const uint32_t currentNode : changedNodes) {
+		if (m_grid->getNodeCost(currentNode) == NavigationGrid::BLOCKED) {
+			continue;
+		}
+
+		// the node may have become passable, it is reached through its neighbors
+		const glm::ivec2 coords = m_grid->getNodeCoords(currentNode);
+		uint32_t& distance = m_distances[currentNode];
+		if (isGoal(coords)) {
+			distance = 0;
+		}
+		for (const auto& offset : NEIGHBOR_OFFSETS) {
+			const glm::ivec2 neighbor = coords + offset;
+			if (neighbor.x < 0 || neighbor.y < 0 || neighbor.x >= size.x || neighbor.y >= size.y) {
+				continue;
+			}
+			const uint32_t neighborNode = m_grid->getNodeIndex(neighbor);
+			const uint16_t neighborCost = m_grid->getNodeCost(neighborNode);
+			if (neighborCost != NavigationGrid::BLOCKED && m_distances[neighborNode] != UNREACHABLE) {
+				distance = std::min(distance, m_distances[neighborNode] + NavigationGrid::STEP_COST + neighborCost);
+			}
+		}
+
+		// entering the node got cheaper, so its neighbors have to be relaxed again
+		if (distance != UNREACHABLE) {
+			m_queue.emplace_back(distance, currentNode);
+			std::push_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+		}
+	}
+	propagate();
+}
+
+void FlowField::propagate() {
+	while (!m_queue.empty()) {
+		std::pop_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+		const QueueEntry entry = m_queue.back();
+		m_queue.pop_back();
+		if (entry.first == m_distances[entry.second]) {
+			relaxNeighbors(entry.second);
+		}
+	}
+}
+
+void FlowField::relaxNeighbors(const uint32_t node) {
+	const glm::ivec2 size(m_grid->getWidthNodes(), m_grid->getHeightNodes());
+	const glm::ivec2 coords = m_grid->getNodeCoords(node);
+	// a neighbor reaches the goal by moving into this node
+	const uint32_t distance = m_distances[node] + NavigationGrid::STEP_COST + m_grid->getNodeCost(node);
+	for (const auto& offset : NEIGHBOR_OFFSETS) {
+		const glm::ivec2 neighbor = coords + offset;
+		if (neighbor.x < 0 || neighbor.y < 0 || neighbor.x >= size.x || neighbor.y >= size.y) {
+			continue;
+		}
+		const uint32_t neighborNode = m_grid->getNodeIndex(neighbor);
+		if (m_grid->getNodeCost(neighborNode) != NavigationGrid::BLOCKED && distance < m_distances[neighborNode]) {
+			m_distances[neighborNode] = distance;
+			m_queue.emplace_back(distance, neighborNode);
+			std::push_heap(m_queue.begin(), m_queue.end(), std::greater<QueueEntry>());
+		}
+	}
+}
+
+glm::ivec2 FlowField::getDirection(const uint32_t node) const {
+	if (m_distances[node] == 0 || m_distances[node] == UNREACHABLE) {
+		return glm::ivec2(0, 0);
+	}
+
+	const glm::ivec2 size(m_grid->getWidthNodes(), m_grid->getHeightNodes());
+	const glm::ivec2 coords = m_grid->getNodeCoords(node);
+	glm::ivec2 bestDirection(0, 0);
+	uint32_t bestDistance = m_distances[node];
+	for (const auto& offset : NEIGHBOR_OFFSETS) {
+		const glm::ivec2 neighbor = coords + offset;
+		if (neighbor.x < 0 || neighbor.y < 0 || neighbor.x >= size.x || neighbor.y >= size.y) {
+			continue;
+		}
+		const uint32_t neighborNode = m_grid->getNodeIndex(neighbor);
+		const uint16_t neighborCost = m_grid->getNodeCost(neighborNode);
+		if (neighborCost == NavigationGrid::BLOCKED || m_distances[neighborNode] == UNREACHABLE) {
+			continue;
+		}
+		const uint32_t distance = m_distances[neighborNode] + NavigationGrid::STEP_COST + neighborCost;
+		if (distance <= bestDistance) {
+			bestDistance = distance;
+			bestDirection = offset;
+		}
+	}
+	return bestDirection;
+}
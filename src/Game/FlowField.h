@@ -0,0 +1,105 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <glm/vec2.hpp>
+
+#include "../Physics/PhysicsEngine.h"
+
+// Movement costs of the level on the 4 px lattice tanks move on.
+// The level is split into cells of CELL_SIZE pixels. A node is the position of a tank
+// and covers TANK_CELLS x TANK_CELLS cells starting at its own cell.
+class NavigationGrid {
+public:
+	static constexpr unsigned int CELL_SIZE = 4;
+	static constexpr size_t TANK_CELLS = 4;
+	static constexpr uint16_t BLOCKED = std::numeric_limits<uint16_t>::max();
+	// extra cost of a brick cell, the tank has to shoot its way through
+	static constexpr uint16_t BRICK_CELL_COST = 2;
+	static constexpr uint32_t STEP_COST = 1;
+
+	NavigationGrid();
+
+	// clears every cell, origin is the bottom left corner of the level in pixels
+	void reset(const size_t widthCells, const size_t heightCells, const glm::vec2& origin);
+
+	void setArea(const Physics::AABB& area, const uint16_t cost);
+	// applies the cells changed since the last call to the node costs,
+	// returns false if some node got more expensive
+	bool commitChanges(std::vector<uint32_t>& changedNodes);
+
+	size_t getWidthCells() const { return m_widthCells; }
+	size_t getHeightCells() const { return m_heightCells; }
+	size_t getWidthNodes() const { return m_widthNodes; }
+	size_t getHeightNodes() const { return m_heightNodes; }
+	size_t getNodesCount() const { return m_nodeCosts.size(); }
+	uint16_t getNodeCost(const uint32_t node) const { return m_nodeCosts[node]; }
+	uint16_t getCellCost(const glm::ivec2& cell) const { return m_cellCosts[cell.y * m_widthCells + cell.x]; }
+
+	// nearest node to a position in pixels, clamped to the grid
+	glm::ivec2 getNode(const glm::vec2& position) const;
+	uint32_t getNodeIndex(const glm::ivec2& node) const { return static_cast<uint32_t>(node.y * m_widthNodes + node.x); }
+	glm::ivec2 getNodeCoords(const uint32_t node) const { return glm::ivec2(node % m_widthNodes, node / m_widthNodes); }
+	glm::vec2 getNodePosition(const glm::ivec2& node) const { return m_origin + glm::vec2(node) * static_cast<float>(CELL_SIZE); }
+	// cells covered by an area in pixels, [min, max)
+	void getCells(const Physics::AABB& area, glm::ivec2& min, glm::ivec2& max) const;
+
+private:
+	uint16_t calculateNodeCost(const glm::ivec2& node) const;
+
+	size_t m_widthCells;
+	size_t m_heightCells;
+	size_t m_widthNodes;
+	size_t m_heightNodes;
+	glm::vec2 m_origin;
+	std::vector<uint16_t> m_cellCosts;
+	std::vector<uint16_t> m_nodeCosts;
+
+	// cells changed since the last commit, [min, max)
+	glm::ivec2 m_dirtyMin;
+	glm::ivec2 m_dirtyMax;
+};
+
+// Distances from every node to a goal area, shared by all tanks heading for it.
+// Costs only drop while a level is played (bricks get destroyed), such changes are
+// propagated from the changed nodes instead of recomputing the whole field.
+class FlowField {
+public:
+	static constexpr uint32_t UNREACHABLE = std::numeric_limits<uint32_t>::max();
+
+	explicit FlowField(const NavigationGrid* grid);
+
+	FlowField(const FlowField&) = delete;
+	FlowField& operator = (const FlowField&) = delete;
+
+	// goals are the nodes touching the area, in cells [min, max)
+	void setGoal(const glm::ivec2& goalMin, const glm::ivec2& goalMax);
+	void clearGoal();
+	bool hasGoal() const { return m_hasGoal; }
+	const glm::ivec2& getGoalMin() const { return m_goalMin; }
+	const glm::ivec2& getGoalMax() const { return m_goalMax; }
+
+	void rebuild();
+	void onCostsDecreased(const std::vector<uint32_t>& changedNodes);
+
+	uint32_t getDistance(const uint32_t node) const { return m_distances[node]; }
+	// direction of the neighbor closest to the goal, (0, 0) at a goal or if the goal can't be reached
+	glm::ivec2 getDirection(const uint32_t node) const;
+
+private:
+	bool isGoal(const glm::ivec2& node) const;
+	void propagate();
+	void relaxNeighbors(const uint32_t node);
+
+	typedef std::pair<uint32_t, uint32_t> QueueEntry;
+
+	const NavigationGrid* m_grid;
+	std::vector<uint32_t> m_distances;
+	std::vector<QueueEntry> m_queue;
+	glm::ivec2 m_goalMin;
+	glm::ivec2 m_goalMax;
+	bool m_hasGoal;
+};
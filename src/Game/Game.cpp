@@ -7,9 +7,12 @@
 
 #include "GameObjects/Tank.h"
 #include "GameObjects/Bullet.h"
+#include "GameObjects/BrickWall.h"
 
 #include "GameStates/Level.h"
 #include "GameStates/StartScreen.h"
+#include "Agent/AgentChannel.h"
+#include "Replay.h"
 #include "../Physics/PhysicsEngine.h"
 #include "../Renderer/Renderer.h"
 
@@ -17,11 +20,19 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <algorithm>
+#include <chrono>
 
 Game::Game(const glm::uvec2& windowSize) 
     : m_eCurrentGameState(EGameState::StartScreen)
     , m_windowSize(windowSize)
     , m_currentLevelIndex(0)
+    , m_preloadedLevelIndex(0)
+    , m_eAgentGameMode(EGameMode::OnePlayer)
+    , m_agentTick(0)
+    , m_agentDestroyedEnemyTanks(0)
+    , m_isReplayFinished(false)
+    , m_fixedTickTime(0)
 {
 	m_keys.fill(false);
 }
@@ -32,7 +43,19 @@ void Game::setWindowSize(const glm::uvec2& windowSize) {
 }
 
 Game::~Game() {
+    stopRecording();
+    // workers may still hold levels that use the visuals unloaded below
+    if (m_preloadedLevel.valid()) {
+        m_preloadedLevel.wait();
+    }
+    m_replacedGameStates.clear();
+    for (const auto& teardown : m_teardowns) {
+        teardown.wait();
+    }
 
+    Tank::unloadVisuals();
+    Bullet::unloadVisuals();
+    BrickWall::unloadSprites();
 }
 
 void Game::render() {
@@ -62,12 +85,68 @@ void Game::updateViewport() {
     m_spriteShaderProgram->setMatrix4("projectionMat", projectionMatrix);
 }
 
+void Game::preloadLevel(const size_t level) {
+    if (level >= ResourceManager::getLevels().size()) {
+        return;
+    }
+    m_preloadedLevelIndex = level;
+    // the game mode only matters once the level is initialized, it is set when the level starts
+    m_preloadedLevel = std::async(std::launch::async, [level]()
+        {
+            return std::make_shared<Level>(ResourceManager::getLevels()[level], EGameMode::OnePlayer);
+        }
+    );
+}
+
+void Game::retireGameStates() {
+    m_teardowns.erase(std::remove_if(m_teardowns.begin(), m_teardowns.end(), [](const std::future<void>& teardown)
+        {
+            return teardown.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        }), m_teardowns.end());
+
+    if (!m_replacedGameStates.empty()) {
+        m_teardowns.push_back(std::async(std::launch::async, [gameStates = std::move(m_replacedGameStates)]() mutable
+            {
+                gameStates.clear();
+            }
+        ));
+        m_replacedGameStates.clear();
+    }
+}
+
 void Game::startNewLevel(const size_t level, const EGameMode eGameMode) {
     m_currentLevelIndex = level;
-    auto pLevel = std::make_shared<Level>(ResourceManager::getLevels()[m_currentLevelIndex], eGameMode);
+    m_agentResetSnapshot.clear();
+    std::shared_ptr<Level> pLevel;
+    if (m_preloadedLevel.valid() && m_preloadedLevelIndex == level) {
+        // blocks only if the worker has not finished yet
+        pLevel = m_preloadedLevel.get();
+        pLevel->setGameMode(eGameMode);
+    }
+    else {
+        if (m_preloadedLevel.valid()) {
+            // another level was prepared, let a worker wait for it and drop it
+            m_teardowns.push_back(std::async(std::launch::async, [preloadedLevel = std::move(m_preloadedLevel)]() mutable
+                {
+                    preloadedLevel.get();
+                }
+            ));
+        }
+        pLevel = std::make_shared<Level>(ResourceManager::getLevels()[m_currentLevelIndex], eGameMode);
+    }
+
+    m_replacedGameStates.push_back(std::move(m_currentGameState));
     m_currentGameState = pLevel;
+    m_eCurrentGameState = EGameState::Level;
+    m_agentDestroyedEnemyTanks = 0;
+    if (m_replayRecorder || m_replayPlayer) {
+        // without a time budget the enemies decide the same way on every run
+        pLevel->setAIBudget(0);
+    }
     Physics::PhysicsEngine::setCurrentLevel(pLevel);
     updateViewport();
+
+    preloadLevel(level + 1);
 }
 
 void Game::nextLevel(const EGameMode eGameMode) {
@@ -75,8 +154,206 @@ void Game::nextLevel(const EGameMode eGameMode) {
 }
 
 void Game::update(const double delta) {
-    m_currentGameState->processInput(m_keys);
-    m_currentGameState->update(delta);
+    retireGameStates();
+    if (m_agentChannel) {
+        // the agent steps the game, without its actions the game waits
+        if (applyAgentActions()) {
+            m_currentGameState->update(FIXED_TICK);
+            ++m_agentTick;
+            publishAgentObservation();
+        }
+        return;
+    }
+
+    if (!m_replayRecorder && !m_replayPlayer) {
+        m_currentGameState->processInput(m_keys);
+        m_currentGameState->update(delta);
+        return;
+    }
+
+    // a recording is played back tick for tick, so both run the same fixed ticks
+    m_fixedTickTime += delta;
+    while (m_fixedTickTime >= FIXED_TICK) {
+        m_fixedTickTime -= FIXED_TICK;
+        if (m_replayPlayer && !applyReplayTick()) {
+            finishReplay();
+            return;
+        }
+        if (m_replayRecorder) {
+            m_replayRecorder->recordTick(m_keys, nullptr, false);
+        }
+        if (!m_replayPlayer || !m_replayPlayer->getHeader().hasAgent) {
+            m_currentGameState->processInput(m_keys);
+        }
+        m_currentGameState->update(FIXED_TICK);
+    }
+}
+
+bool Game::startRecording(const std::string& path) {
+    Replay::Header header;
+    header.tickTime = FIXED_TICK;
+    header.startsInLevel = m_eCurrentGameState == EGameState::Level;
+    header.levelIndex = static_cast<uint32_t>(m_currentLevelIndex);
+    header.gameMode = static_cast<uint8_t>(m_eAgentGameMode);
+    header.hasAgent = m_agentChannel != nullptr;
+    if (header.startsInLevel && !header.hasAgent) {
+        header.gameMode = static_cast<uint8_t>(static_cast<Level&>(*m_currentGameState).getGameMode());
+    }
+
+    m_replayRecorder = ReplayRecorder::create(path, header);
+    if (!m_replayRecorder) {
+        return false;
+    }
+    m_fixedTickTime = 0;
+    if (header.startsInLevel) {
+        static_cast<Level&>(*m_currentGameState).setAIBudget(0);
+    }
+    return true;
+}
+
+void Game::stopRecording() {
+    if (m_replayRecorder) {
+        m_replayRecorder->finish(getWorldChecksum());
+        m_replayRecorder = nullptr;
+    }
+}
+
+bool Game::startReplay(const std::string& path) {
+    m_replayPlayer = ReplayPlayer::open(path);
+    if (!m_replayPlayer) {
+        return false;
+    }
+    const Replay::Header& header = m_replayPlayer->getHeader();
+    if (header.tickTime != FIXED_TICK) {
+        std::cerr << "Replay was recorded with ticks of " << header.tickTime << " ms instead of " << FIXED_TICK << " ms" << std::endl;
+    }
+    if (header.startsInLevel && header.levelIndex >= ResourceManager::getLevels().size()) {
+        std::cerr << "Replay starts in the missing level " << header.levelIndex << std::endl;
+        m_replayPlayer = nullptr;
+        return false;
+    }
+
+    m_isReplayFinished = false;
+    m_fixedTickTime = 0;
+    m_eAgentGameMode = static_cast<EGameMode>(header.gameMode);
+    if (header.startsInLevel) {
+        startNewLevel(header.levelIndex, static_cast<EGameMode>(header.gameMode));
+    }
+    return true;
+}
+
+bool Game::applyReplayTick() {
+    if (!m_replayPlayer->advance()) {
+        return false;
+    }
+    if (m_replayPlayer->getHeader().hasAgent) {
+        applyActions(m_replayPlayer->getAgentActions(), m_replayPlayer->isAgentReset());
+        return true;
+    }
+
+    const Replay::Keys& keys = m_replayPlayer->getKeys();
+    for (size_t currentKey = 0; currentKey < keys.size(); ++currentKey) {
+        if (keys[currentKey] != m_keys[currentKey]) {
+            setKey(static_cast<int>(currentKey), keys[currentKey]);
+        }
+    }
+    return true;
+}
+
+void Game::finishReplay() {
+    const uint64_t recordedChecksum = m_replayPlayer->getWorldChecksum();
+    const uint64_t checksum = getWorldChecksum();
+    // 0 means there was no world state to compare, at either end
+    const char* result = "was not checked";
+    if (checksum != 0 && recordedChecksum != 0) {
+        result = checksum == recordedChecksum ? "matches the recording" : "differs from the recording";
+    }
+    std::cout << "Replayed " << m_replayPlayer->getTicksCount() << " ticks, the world state " << result << std::endl;
+
+    // the keys take over from where the replay stopped
+    m_replayPlayer = nullptr;
+    m_isReplayFinished = true;
+    m_keys.fill(false);
+}
+
+uint64_t Game::getWorldChecksum() {
+    if (m_eCurrentGameState != EGameState::Level) {
+        return 0;
+    }
+    Level& level = static_cast<Level&>(*m_currentGameState);
+    level.captureWorldState();
+    return Replay::getChecksum(level.getWorldState());
+}
+
+bool Game::attachAgent(const std::string& channelName, const EGameMode eGameMode) {
+    m_agentChannel = AgentChannel::create(channelName);
+    if (!m_agentChannel) {
+        return false;
+    }
+    m_eAgentGameMode = eGameMode;
+    m_agentTick = 0;
+    startNewLevel(0, eGameMode);
+    static_cast<Level&>(*m_currentGameState).saveSnapshot(m_agentResetSnapshot);
+    publishAgentObservation();
+    return true;
+}
+
+bool Game::applyAgentActions() {
+    const Agent::ActionFrame* frame = m_agentChannel->waitForAction(AGENT_ACTION_TIMEOUT);
+    if (!frame) {
+        return false;
+    }
+
+    if (m_replayRecorder) {
+        m_replayRecorder->recordTick(m_keys, &frame->actions, frame->reset != 0);
+    }
+    applyActions(frame->actions, frame->reset != 0);
+    m_agentChannel->popAction();
+    return true;
+}
+
+void Game::applyActions(const Replay::AgentActions& actions, const bool isReset) {
+    if (isReset) {
+        resetAgentLevel();
+    }
+    Level& level = static_cast<Level&>(*m_currentGameState);
+    for (size_t currentPlayer = 0; currentPlayer < actions.size(); ++currentPlayer) {
+        const Agent::Action& action = actions[currentPlayer];
+        level.applyPlayerAction(currentPlayer, glm::ivec2(action.directionX, action.directionY), action.fire != 0);
+    }
+}
+
+void Game::resetAgentLevel() {
+    if (m_eCurrentGameState == EGameState::Level && !m_agentResetSnapshot.empty()
+        && static_cast<Level&>(*m_currentGameState).restoreSnapshot(m_agentResetSnapshot.data(), m_agentResetSnapshot.size())) {
+        m_agentDestroyedEnemyTanks = 0;
+        return;
+    }
+    startNewLevel(m_currentLevelIndex, m_eAgentGameMode);
+    static_cast<Level&>(*m_currentGameState).saveSnapshot(m_agentResetSnapshot);
+}
+
+void Game::publishAgentObservation() {
+    Agent::ObservationFrame* frame = m_agentChannel->beginObservation();
+    if (!frame) {
+        // the agent does not keep up, it gets the next one
+        return;
+    }
+
+    Level& level = static_cast<Level&>(*m_currentGameState);
+    level.captureWorldState();
+    const WorldState* worldState = level.getWorldState();
+    frame->tick = m_agentTick;
+    frame->isWorldValid = worldState != nullptr;
+    if (worldState) {
+        frame->world = *worldState;
+    }
+    // the players share the reward, the game does not track who destroyed a tank
+    const float reward = static_cast<float>(level.getDestroyedEnemyTanks() - m_agentDestroyedEnemyTanks);
+    frame->rewards.fill(reward);
+    m_agentDestroyedEnemyTanks = level.getDestroyedEnemyTanks();
+    frame->done = level.isCleared();
+    m_agentChannel->commitObservation();
 }
 
 void Game::setKey(const int key, const int action) {
@@ -85,6 +362,9 @@ void Game::setKey(const int key, const int action) {
 
 bool Game::init() {
     ResourceManager::loadJSONResources("res/resources.json");
+    Tank::loadVisuals();
+    Bullet::loadVisuals();
+    BrickWall::loadSprites();
 
     m_spriteShaderProgram = ResourceManager::getShaderProgram("spriteShader");
     if (!m_spriteShaderProgram) {
@@ -96,6 +376,7 @@ bool Game::init() {
     m_spriteShaderProgram->setInt("tex", 0);
 
     m_currentGameState = std::make_shared<StartScreen>(ResourceManager::getStartScreen(), this);
+    preloadLevel(0);
 
     setWindowSize(m_windowSize);
 
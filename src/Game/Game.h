@@ -2,8 +2,16 @@
 
 #include <glm/vec2.hpp>
 #include <array>
+#include <memory>
+#include <vector>
+#include <future>
+#include <string>
+
+#include "Replay.h"
 
 class IGameState;
+class Level;
+class AgentChannel;
 
 namespace RenderEngine {
 	class ShaderProgram;
@@ -16,6 +24,12 @@ public:
 		TwoPlayers
 	};
 
+	// simulated time of a tick when the game runs in fixed ticks: stepped by an agent,
+	// recorded, replayed or without a window (ms)
+	static constexpr double FIXED_TICK = 1000.0 / 60.0;
+	// how long a tick waits for the actions of the agent before the window gets control back (ms)
+	static constexpr double AGENT_ACTION_TIMEOUT = 100;
+
 	Game(const glm::uvec2& m_windowSize);
 	~Game();
 
@@ -29,9 +43,39 @@ public:
 	void nextLevel(const EGameMode eGameMode);
 	void updateViewport();
 	void setWindowSize(const glm::uvec2& windowSize);
+	// the players are controlled by an agent process through shared memory instead of the keys;
+	// the game starts the first level and then advances one fixed tick per action of the agent
+	bool attachAgent(const std::string& channelName, const EGameMode eGameMode);
+	bool isAgentAttached() const { return m_agentChannel != nullptr; }
+	// the input of every tick is written to the file, the game runs in fixed ticks from now on;
+	// enemy decisions are not time-sliced while recording, so a replay makes the same ones
+	bool startRecording(const std::string& path);
+	// closes the replay with the checksum of the world state
+	void stopRecording();
+	// plays the input of a replay instead of the keys, has to be started right after init;
+	// the world state after the last tick is checked against the recorded one
+	bool startReplay(const std::string& path);
+	bool isReplaying() const { return m_replayPlayer != nullptr; }
+	bool isReplayFinished() const { return m_isReplayFinished; }
 
 private:
-	std::array<bool, 349> m_keys;
+	// builds the level on a worker thread, starting it later is only a pointer exchange
+	void preloadLevel(const size_t level);
+	// hands the states replaced since the last update to a worker thread that destroys them
+	void retireGameStates();
+	// waits for the actions of the agent and applies them, false if none came in time
+	bool applyAgentActions();
+	void applyActions(const Replay::AgentActions& actions, const bool isReset);
+	// puts the level back to its start for the agent
+	void resetAgentLevel();
+	// input of the next replayed tick, false once the replay is over
+	bool applyReplayTick();
+	void finishReplay();
+	// checksum of the current level, 0 outside of a level or if the level is too large for a world state
+	uint64_t getWorldChecksum();
+	void publishAgentObservation();
+
+	Replay::Keys m_keys;
 
 	enum class EGameState {
 		StartScreen,
@@ -48,4 +92,23 @@ private:
 	std::shared_ptr<IGameState> m_currentGameState;
 	std::shared_ptr<RenderEngine::ShaderProgram> m_spriteShaderProgram;
 	size_t m_currentLevelIndex;
+
+	std::future<std::shared_ptr<Level>> m_preloadedLevel;
+	size_t m_preloadedLevelIndex;
+	// not destroyed in place, the state may be replaced from inside its own processInput
+	std::vector<std::shared_ptr<IGameState>> m_replacedGameStates;
+	std::vector<std::future<void>> m_teardowns;
+
+	std::unique_ptr<AgentChannel> m_agentChannel;
+	EGameMode m_eAgentGameMode;
+	uint64_t m_agentTick;
+	size_t m_agentDestroyedEnemyTanks;
+	// the current level right after its start, the agent resets restore it instead of building the level again
+	std::vector<uint8_t> m_agentResetSnapshot;
+
+	std::unique_ptr<ReplayRecorder> m_replayRecorder;
+	std::unique_ptr<ReplayPlayer> m_replayPlayer;
+	bool m_isReplayFinished;
+	// simulated time not yet stepped by a fixed tick (ms)
+	double m_fixedTickTime;
 };
\ No newline at end of file
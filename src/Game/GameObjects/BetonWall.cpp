@@ -75,8 +75,4 @@ void BetonWall::render() const {
 	renderBlock(EBlockLocation::TopRight);
 	renderBlock(EBlockLocation::BottomLeft);
 	renderBlock(EBlockLocation::BottomRight);
-}
-
-void BetonWall::update(const double) {
-
 }
\ No newline at end of file
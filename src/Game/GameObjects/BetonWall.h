@@ -38,7 +38,6 @@ public:
 
 	BetonWall(const EBetonWallType eBetonWallType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
 	virtual void render() const override;
-	virtual void update(const double) override;
 
 private:
 	void renderBlock(const EBlockLocation eBlockLocation) const;
@@ -5,182 +5,329 @@
 
 #include <iostream>
 
-BrickWall::EBrickState BrickWall::getBrickStateAfterCollision(const EBrickState currentState, const Physics::ECollisionDirection direction) {
-    switch (currentState)
-    {
-    case EBrickState::All:
+namespace {
+    constexpr size_t BRICK_STATES_COUNT = static_cast<size_t>(BrickWall::EBrickState::Destroyed) + 1;
+    constexpr size_t BRICK_LOCATIONS_COUNT = 4;
+    constexpr size_t COLLISION_DIRECTIONS_COUNT = 4;
+
+    // quarters of a brick
+    constexpr uint8_t TOP_LEFT = 1 << 0;
+    constexpr uint8_t TOP_RIGHT = 1 << 1;
+    constexpr uint8_t BOTTOM_LEFT = 1 << 2;
+    constexpr uint8_t BOTTOM_RIGHT = 1 << 3;
+    constexpr uint8_t TOP_ROW = TOP_LEFT | TOP_RIGHT;
+    constexpr uint8_t BOTTOM_ROW = BOTTOM_LEFT | BOTTOM_RIGHT;
+    constexpr uint8_t LEFT_COLUMN = TOP_LEFT | BOTTOM_LEFT;
+    constexpr uint8_t RIGHT_COLUMN = TOP_RIGHT | BOTTOM_RIGHT;
+    constexpr uint8_t ALL_QUARTERS = TOP_ROW | BOTTOM_ROW;
+
+    // EBrickState values are the masks of the quarters left, only All and Destroyed are swapped
+    constexpr uint8_t getQuarters(const BrickWall::EBrickState eBrickState) {
+        const uint8_t value = static_cast<uint8_t>(eBrickState);
+        return value == 0 ? ALL_QUARTERS : (value == ALL_QUARTERS ? 0 : value);
+    }
+
+    constexpr BrickWall::EBrickState getBrickState(const uint8_t quarters) {
+        return static_cast<BrickWall::EBrickState>(quarters == ALL_QUARTERS ? 0 : (quarters == 0 ? ALL_QUARTERS : quarters));
+    }
+
+    constexpr uint8_t getQuartersFacing(const Physics::ECollisionDirection direction) {
         switch (direction)
         {
-        case Physics::ECollisionDirection::Left:
-            return EBrickState::Right;
-        case Physics::ECollisionDirection::Right:
-            return EBrickState::Left;
         case Physics::ECollisionDirection::Top:
-            return EBrickState::Bottom;
+            return TOP_ROW;
         case Physics::ECollisionDirection::Bottom:
-            return EBrickState::Top;
-        }
-
-    case EBrickState::Top:
-        switch (direction)
-        {
+            return BOTTOM_ROW;
         case Physics::ECollisionDirection::Left:
-            return EBrickState::TopRight;
+            return LEFT_COLUMN;
         case Physics::ECollisionDirection::Right:
-            return EBrickState::TopLeft;
-        case Physics::ECollisionDirection::Top:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Bottom:
-            return EBrickState::Destroyed;
+            return RIGHT_COLUMN;
         }
+        return 0;
+    }
 
-    case EBrickState::Bottom:
-        switch (direction)
-        {
-        case Physics::ECollisionDirection::Left:
-            return EBrickState::BottomRight;
-        case Physics::ECollisionDirection::Right:
-            return EBrickState::BottomLeft;
-        case Physics::ECollisionDirection::Top:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Bottom:
-            return EBrickState::Destroyed;
+    // a hit knocks out the half facing the bullet, a half brick hit from its empty side is destroyed,
+    // anything smaller than a half or not rectangular is destroyed by any hit
+    constexpr uint8_t getQuartersAfterCollision(const uint8_t quarters, const Physics::ECollisionDirection direction) {
+        if (quarters != ALL_QUARTERS && quarters != TOP_ROW && quarters != BOTTOM_ROW && quarters != LEFT_COLUMN && quarters != RIGHT_COLUMN) {
+            return 0;
         }
+        const uint8_t quartersLeft = quarters & ~getQuartersFacing(direction);
+        return quartersLeft == quarters ? 0 : quartersLeft;
+    }
 
-    case EBrickState::Left:
-        switch (direction)
-        {
-        case Physics::ECollisionDirection::Left:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Right:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Top:
-            return EBrickState::BottomLeft;
-        case Physics::ECollisionDirection::Bottom:
-            return EBrickState::TopLeft;
+    // collider of a brick in quarters of the wall block, the offset of the brick location included
+    struct BrickBox {
+        uint8_t left;
+        uint8_t bottom;
+        uint8_t right;
+        uint8_t top;
+    };
+
+    constexpr BrickBox getBrickBox(const BrickWall::EBrickLocation location, const uint8_t quarters) {
+        const uint8_t offsetX = (location == BrickWall::EBrickLocation::TopRight || location == BrickWall::EBrickLocation::BottomRight) ? 2 : 0;
+        const uint8_t offsetY = (location == BrickWall::EBrickLocation::TopLeft || location == BrickWall::EBrickLocation::TopRight) ? 2 : 0;
+        if (quarters == 0) {
+            return { offsetX, offsetY, offsetX, offsetY };
         }
+        return { static_cast<uint8_t>(offsetX + ((quarters & LEFT_COLUMN) ? 0 : 1)),
+                 static_cast<uint8_t>(offsetY + ((quarters & BOTTOM_ROW) ? 0 : 1)),
+                 static_cast<uint8_t>(offsetX + ((quarters & RIGHT_COLUMN) ? 2 : 1)),
+                 static_cast<uint8_t>(offsetY + ((quarters & TOP_ROW) ? 2 : 1)) };
+    }
 
-    case EBrickState::Right:
-        switch (direction)
-        {
-        case Physics::ECollisionDirection::Left:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Right:
-            return EBrickState::Destroyed;
-        case Physics::ECollisionDirection::Top:
-            return EBrickState::BottomRight;
-        case Physics::ECollisionDirection::Bottom:
-            return EBrickState::TopRight;
+    constexpr auto BRICK_STATE_TRANSITIONS = [] {
+        std::array<std::array<BrickWall::EBrickState, COLLISION_DIRECTIONS_COUNT>, BRICK_STATES_COUNT> transitions{};
+        for (size_t currentState = 0; currentState < BRICK_STATES_COUNT; ++currentState) {
+            for (size_t currentDirection = 0; currentDirection < COLLISION_DIRECTIONS_COUNT; ++currentDirection) {
+                const uint8_t quarters = getQuarters(static_cast<BrickWall::EBrickState>(currentState));
+                transitions[currentState][currentDirection] = getBrickState(getQuartersAfterCollision(quarters, static_cast<Physics::ECollisionDirection>(currentDirection)));
+            }
+        }
+        return transitions;
+    }();
+
+    constexpr auto BRICK_BOXES = [] {
+        std::array<std::array<BrickBox, BRICK_STATES_COUNT>, BRICK_LOCATIONS_COUNT> boxes{};
+        for (size_t currentLocation = 0; currentLocation < BRICK_LOCATIONS_COUNT; ++currentLocation) {
+            for (size_t currentState = 0; currentState < BRICK_STATES_COUNT; ++currentState) {
+                boxes[currentLocation][currentState] = getBrickBox(static_cast<BrickWall::EBrickLocation>(currentLocation), getQuarters(static_cast<BrickWall::EBrickState>(currentState)));
+            }
+        }
+        return boxes;
+    }();
+
+    // the switches the tables replaced, kept to check the tables at compile time
+    namespace reference {
+        constexpr BrickWall::EBrickState getBrickStateAfterCollision(const BrickWall::EBrickState currentState, const Physics::ECollisionDirection direction) {
+            switch (currentState)
+            {
+            case BrickWall::EBrickState::All:
+                switch (direction)
+                {
+                case Physics::ECollisionDirection::Left:
+                    return BrickWall::EBrickState::Right;
+                case Physics::ECollisionDirection::Right:
+                    return BrickWall::EBrickState::Left;
+                case Physics::ECollisionDirection::Top:
+                    return BrickWall::EBrickState::Bottom;
+                case Physics::ECollisionDirection::Bottom:
+                    return BrickWall::EBrickState::Top;
+                }
+                break;
+
+            case BrickWall::EBrickState::Top:
+                switch (direction)
+                {
+                case Physics::ECollisionDirection::Left:
+                    return BrickWall::EBrickState::TopRight;
+                case Physics::ECollisionDirection::Right:
+                    return BrickWall::EBrickState::TopLeft;
+                case Physics::ECollisionDirection::Top:
+                case Physics::ECollisionDirection::Bottom:
+                    return BrickWall::EBrickState::Destroyed;
+                }
+                break;
+
+            case BrickWall::EBrickState::Bottom:
+                switch (direction)
+                {
+                case Physics::ECollisionDirection::Left:
+                    return BrickWall::EBrickState::BottomRight;
+                case Physics::ECollisionDirection::Right:
+                    return BrickWall::EBrickState::BottomLeft;
+                case Physics::ECollisionDirection::Top:
+                case Physics::ECollisionDirection::Bottom:
+                    return BrickWall::EBrickState::Destroyed;
+                }
+                break;
+
+            case BrickWall::EBrickState::Left:
+                switch (direction)
+                {
+                case Physics::ECollisionDirection::Left:
+                case Physics::ECollisionDirection::Right:
+                    return BrickWall::EBrickState::Destroyed;
+                case Physics::ECollisionDirection::Top:
+                    return BrickWall::EBrickState::BottomLeft;
+                case Physics::ECollisionDirection::Bottom:
+                    return BrickWall::EBrickState::TopLeft;
+                }
+                break;
+
+            case BrickWall::EBrickState::Right:
+                switch (direction)
+                {
+                case Physics::ECollisionDirection::Left:
+                case Physics::ECollisionDirection::Right:
+                    return BrickWall::EBrickState::Destroyed;
+                case Physics::ECollisionDirection::Top:
+                    return BrickWall::EBrickState::BottomRight;
+                case Physics::ECollisionDirection::Bottom:
+                    return BrickWall::EBrickState::TopRight;
+                }
+                break;
+
+            default:
+                break;
+            }
+            return BrickWall::EBrickState::Destroyed;
+        }
+
+        // in quarters of the wall block, i.e. for a block size of 4
+        constexpr BrickBox getAABBForBrickState(const BrickWall::EBrickLocation location, const BrickWall::EBrickState eBrickState) {
+            uint8_t offsetX = 0;
+            uint8_t offsetY = 0;
+            switch (location)
+            {
+            case BrickWall::EBrickLocation::BottomLeft:
+                break;
+            case BrickWall::EBrickLocation::BottomRight:
+                offsetX = 2;
+                break;
+            case BrickWall::EBrickLocation::TopLeft:
+                offsetY = 2;
+                break;
+            case BrickWall::EBrickLocation::TopRight:
+                offsetX = 2;
+                offsetY = 2;
+                break;
+            }
+
+            BrickBox box{ 0, 0, 0, 0 };
+            switch (eBrickState)
+            {
+            case BrickWall::EBrickState::TopLeft:
+                box = { 0, 1, 1, 2 };
+                break;
+            case BrickWall::EBrickState::TopRight:
+                box = { 1, 1, 2, 2 };
+                break;
+            case BrickWall::EBrickState::Top:
+                box = { 0, 1, 2, 2 };
+                break;
+            case BrickWall::EBrickState::BottomLeft:
+                box = { 0, 0, 1, 1 };
+                break;
+            case BrickWall::EBrickState::Left:
+                box = { 0, 0, 1, 2 };
+                break;
+            case BrickWall::EBrickState::BottomRight:
+                box = { 1, 0, 2, 1 };
+                break;
+            case BrickWall::EBrickState::Right:
+                box = { 1, 0, 2, 2 };
+                break;
+            case BrickWall::EBrickState::Bottom:
+                box = { 0, 0, 2, 1 };
+                break;
+            case BrickWall::EBrickState::All:
+            case BrickWall::EBrickState::TopRight_BottomLeft:
+            case BrickWall::EBrickState::Top_BottomLeft:
+            case BrickWall::EBrickState::TopLeft_BottomRight:
+            case BrickWall::EBrickState::Top_BottomRight:
+            case BrickWall::EBrickState::TopLeft_Bottom:
+            case BrickWall::EBrickState::TopRight_Bottom:
+                box = { 0, 0, 2, 2 };
+                break;
+            case BrickWall::EBrickState::Destroyed:
+                break;
+            }
+            return { static_cast<uint8_t>(box.left + offsetX), static_cast<uint8_t>(box.bottom + offsetY),
+                     static_cast<uint8_t>(box.right + offsetX), static_cast<uint8_t>(box.top + offsetY) };
+        }
+
+        constexpr bool checkTransitions() {
+            for (size_t currentState = 0; currentState < BRICK_STATES_COUNT; ++currentState) {
+                for (size_t currentDirection = 0; currentDirection < COLLISION_DIRECTIONS_COUNT; ++currentDirection) {
+                    const auto eBrickState = static_cast<BrickWall::EBrickState>(currentState);
+                    const auto direction = static_cast<Physics::ECollisionDirection>(currentDirection);
+                    if (BRICK_STATE_TRANSITIONS[currentState][currentDirection] != getBrickStateAfterCollision(eBrickState, direction)) {
+                        return false;
+                    }
+                }
+            }
+            return true;
         }
 
-    default:
-        return EBrickState::Destroyed;
+        constexpr bool checkBoxes() {
+            for (size_t currentLocation = 0; currentLocation < BRICK_LOCATIONS_COUNT; ++currentLocation) {
+                for (size_t currentState = 0; currentState < BRICK_STATES_COUNT; ++currentState) {
+                    const BrickBox box = getAABBForBrickState(static_cast<BrickWall::EBrickLocation>(currentLocation), static_cast<BrickWall::EBrickState>(currentState));
+                    const BrickBox& tableBox = BRICK_BOXES[currentLocation][currentState];
+                    if (box.left != tableBox.left || box.bottom != tableBox.bottom || box.right != tableBox.right || box.top != tableBox.top) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
     }
+
+    static_assert(reference::checkTransitions(), "brick state transition table differs from the reference switch");
+    static_assert(reference::checkBoxes(), "brick collider table differs from the reference switch");
 }
 
-Physics::AABB BrickWall::getAABBForBrickState(const EBrickLocation location, const EBrickState eBrickState, const glm::vec2& size) {
-    glm::vec2 blockOffset(0);
-    switch (location)
-    {
-    case EBrickLocation::BottomLeft:
-        break;
-    case EBrickLocation::BottomRight:
-        blockOffset.x += size.x / 2;
-        break;
-    case EBrickLocation::TopLeft:
-        blockOffset.y += size.y / 2;
-        break;
-    case EBrickLocation::TopRight:
-        blockOffset += size / 2.f;
-        break;
-    }
+BrickWall::EBrickState BrickWall::getBrickStateAfterCollision(const EBrickState currentState, const Physics::ECollisionDirection direction) {
+    return BRICK_STATE_TRANSITIONS[static_cast<size_t>(currentState)][static_cast<size_t>(direction)];
+}
 
-    glm::vec2 bottomLeft(0);
-    glm::vec2 topRight(0);
-    switch (eBrickState)
-    {
-    case EBrickState::All:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::TopLeft:
-        bottomLeft = glm::vec2(0, size.y / 4);
-        topRight = glm::vec2(size.x / 4, size.y / 2);
-        break;
-    case EBrickState::TopRight:
-        bottomLeft = glm::vec2(size.x / 4, size.y / 4);
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Top:
-        bottomLeft = glm::vec2(0, size.y / 4);
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::BottomLeft:
-        topRight = glm::vec2(size.x / 4, size.y / 4);
-        break;
-    case EBrickState::Left:
-        topRight = glm::vec2(size.x / 4, size.y / 2);
-        break;
-    case EBrickState::TopRight_BottomLeft:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Top_BottomLeft:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::BottomRight:
-        bottomLeft = glm::vec2(size.x / 4, 0);
-        topRight = glm::vec2(size.x / 2, size.y / 4);
-        break;
-    case EBrickState::TopLeft_BottomRight:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Right:
-        bottomLeft = glm::vec2(size.x / 4, 0);
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Top_BottomRight:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Bottom:
-        topRight = glm::vec2(size.x / 2, size.y / 4);
-        break;
-    case EBrickState::TopLeft_Bottom:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::TopRight_Bottom:
-        topRight = glm::vec2(size.x / 2, size.y / 2);
-        break;
-    case EBrickState::Destroyed:
-        break;
-    }
+Physics::AABB BrickWall::getAABBForBrickState(const EBrickLocation location, const EBrickState eBrickState, const glm::vec2& size) {
+    const BrickBox& box = BRICK_BOXES[static_cast<size_t>(location)][static_cast<size_t>(eBrickState)];
+    const glm::vec2 quarter = size / 4.f;
+    return { glm::vec2(box.left, box.bottom) * quarter, glm::vec2(box.right, box.top) * quarter };
+}
 
-    return { bottomLeft + blockOffset, topRight + blockOffset };
+uint8_t BrickWall::getBrickQuarters(const EBrickLocation eBrickLocation) const {
+    return getQuarters(m_eCurrentBrickState[static_cast<size_t>(eBrickLocation)]);
 }
 
-void BrickWall::onCollisionCallback(const EBrickLocation location, const IGameObject& object, const Physics::ECollisionDirection direction) {
+void BrickWall::onCollisionCallback(const IGameObject& object, const Physics::ECollisionDirection direction, const uint8_t location) {
     if (object.getObjectType() != IGameObject::EObjectType::Bullet) return;
-    const EBrickState newBrickState = getBrickStateAfterCollision(m_eCurrentBrickState[static_cast<size_t>(location)], direction);
-    m_eCurrentBrickState[static_cast<size_t>(location)] = newBrickState;
+    const EBrickState newBrickState = getBrickStateAfterCollision(m_eCurrentBrickState[location], direction);
+    m_eCurrentBrickState[location] = newBrickState;
+    Physics::Collider& collider = m_colliders[m_brickLocationToColliderMap[location]];
     if (newBrickState != EBrickState::Destroyed)
     {
-        m_brickLocationToColliderMap[static_cast<size_t>(location)]->boundingBox = getAABBForBrickState(location, newBrickState, m_size);
+        collider.boundingBox = getAABBForBrickState(static_cast<EBrickLocation>(location), newBrickState, m_size);
     }
     else
     {
-        m_brickLocationToColliderMap[static_cast<size_t>(location)]->isActive = false;
+        collider.isActive = false;
+    }
+    if (m_onDamage)
+    {
+        m_onDamage(*this);
     }
-};
+}
 
-BrickWall::BrickWall(const EBrickWallType eBrickWallType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer)
-    : IGameObject(IGameObject::EObjectType::BrickWall, position, size, rotation, layer)
-    , m_eCurrentBrickState{ EBrickState::Destroyed,
-                            EBrickState::Destroyed,
-                            EBrickState::Destroyed,
-                            EBrickState::Destroyed }
-    , m_blockOffsets{ glm::vec2(0, m_size.y / 2.f),
-                       glm::vec2(m_size.x / 2.f, m_size.y / 2.f),
-                       glm::vec2(0, 0),
-                       glm::vec2(m_size.x / 2.f, 0) }
-{
+void BrickWall::setBrickStates(const std::array<EBrickState, 4>& eBrickStates) {
+    m_eCurrentBrickState = eBrickStates;
+    for (size_t currentLocation = 0; currentLocation < m_eCurrentBrickState.size(); ++currentLocation) {
+        if (m_brickLocationToColliderMap[currentLocation] == NO_COLLIDER) {
+            continue;
+        }
+        Physics::Collider& collider = m_colliders[m_brickLocationToColliderMap[currentLocation]];
+        collider.isActive = m_eCurrentBrickState[currentLocation] != EBrickState::Destroyed;
+        if (collider.isActive) {
+            collider.boundingBox = getAABBForBrickState(static_cast<EBrickLocation>(currentLocation), m_eCurrentBrickState[currentLocation], m_size);
+        }
+    }
+}
+
+bool BrickWall::isValidBrickState(const EBrickState eBrickState) {
+    return static_cast<size_t>(eBrickState) < BRICK_STATES_COUNT;
+}
+
+void BrickWall::addBrickCollider(const EBrickLocation location) {
+    m_brickLocationToColliderMap[static_cast<size_t>(location)] = static_cast<uint8_t>(m_colliders.size());
+    m_colliders.emplace_back(getAABBForBrickState(location, EBrickState::All, m_size),
+                             Physics::CollisionCallback::bind<BrickWall, &BrickWall::onCollisionCallback>(this, static_cast<uint8_t>(location)));
+}
+
+std::array<std::shared_ptr<RenderEngine::Sprite>, 15> BrickWall::m_sprites;
+
+void BrickWall::loadSprites() {
     m_sprites[static_cast<size_t>(EBrickState::All)] = ResourceManager::getSprite("brickWall_All");
     m_sprites[static_cast<size_t>(EBrickState::TopLeft)] = ResourceManager::getSprite("brickWall_TopLeft");
     m_sprites[static_cast<size_t>(EBrickState::TopRight)] = ResourceManager::getSprite("brickWall_TopRight");
@@ -196,75 +343,72 @@ BrickWall::BrickWall(const EBrickWallType eBrickWallType, const glm::vec2& posit
     m_sprites[static_cast<size_t>(EBrickState::Bottom)] = ResourceManager::getSprite("brickWall_Bottom");
     m_sprites[static_cast<size_t>(EBrickState::TopLeft_Bottom)] = ResourceManager::getSprite("brickWall_TopLeft_Bottom");
     m_sprites[static_cast<size_t>(EBrickState::TopRight_Bottom)] = ResourceManager::getSprite("brickWall_TopRight_Bottom");
+}
 
+void BrickWall::unloadSprites() {
+    m_sprites.fill(nullptr);
+}
 
-    auto onCollisionCallbackTopLeft = [&](const IGameObject& object, const Physics::ECollisionDirection direction)
-    {
-        onCollisionCallback(EBrickLocation::TopLeft, object, direction);
-    };
-    auto onCollisionCallbackTopRight = [&](const IGameObject& object, const Physics::ECollisionDirection direction)
-    {
-        onCollisionCallback(EBrickLocation::TopRight, object, direction);
-    };
-    auto onCollisionCallbackBottomLeft = [&](const IGameObject& object, const Physics::ECollisionDirection direction)
-    {
-        onCollisionCallback(EBrickLocation::BottomLeft, object, direction);
-    };
-    auto onCollisionCallbackBottomRight = [&](const IGameObject& object, const Physics::ECollisionDirection direction)
-    {
-        onCollisionCallback(EBrickLocation::BottomRight, object, direction);
-    };
-
-    m_brickLocationToColliderMap.fill(nullptr);
-    m_colliders.reserve(4);
+BrickWall::BrickWall(const EBrickWallType eBrickWallType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer)
+    : IGameObject(IGameObject::EObjectType::BrickWall, position, size, rotation, layer)
+    , m_eCurrentBrickState{ EBrickState::Destroyed,
+                            EBrickState::Destroyed,
+                            EBrickState::Destroyed,
+                            EBrickState::Destroyed }
+    , m_blockOffsets{ glm::vec2(0, m_size.y / 2.f),
+                       glm::vec2(m_size.x / 2.f, m_size.y / 2.f),
+                       glm::vec2(0, 0),
+                       glm::vec2(m_size.x / 2.f, 0) }
+{
+    m_brickLocationToColliderMap.fill(NO_COLLIDER);
     switch (eBrickWallType)
     {
     case EBrickWallType::All:
         m_eCurrentBrickState.fill(EBrickState::All);
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopLeft, EBrickState::All, m_size), onCollisionCallbackTopLeft));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopRight, EBrickState::All, m_size), onCollisionCallbackTopRight));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomLeft, EBrickState::All, m_size), onCollisionCallbackBottomLeft));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomRight, EBrickState::All, m_size), onCollisionCallbackBottomRight));
+        addBrickCollider(EBrickLocation::TopLeft);
+        addBrickCollider(EBrickLocation::TopRight);
+        addBrickCollider(EBrickLocation::BottomLeft);
+        addBrickCollider(EBrickLocation::BottomRight);
         break;
     case EBrickWallType::Top:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopLeft)] = EBrickState::All;
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopRight)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopLeft, EBrickState::All, m_size), onCollisionCallbackTopLeft));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopRight, EBrickState::All, m_size), onCollisionCallbackTopRight));
+        addBrickCollider(EBrickLocation::TopLeft);
+        addBrickCollider(EBrickLocation::TopRight);
         break;
     case EBrickWallType::Bottom:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomLeft)] = EBrickState::All;
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomRight)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomLeft, EBrickState::All, m_size), onCollisionCallbackBottomLeft));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomRight, EBrickState::All, m_size), onCollisionCallbackBottomRight));
+        addBrickCollider(EBrickLocation::BottomLeft);
+        addBrickCollider(EBrickLocation::BottomRight);
         break;
     case EBrickWallType::Left:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopLeft)] = EBrickState::All;
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomLeft)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopLeft, EBrickState::All, m_size), onCollisionCallbackTopLeft));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomLeft, EBrickState::All, m_size), onCollisionCallbackBottomLeft));
+        addBrickCollider(EBrickLocation::TopLeft);
+        addBrickCollider(EBrickLocation::BottomLeft);
         break;
     case EBrickWallType::Right:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopRight)] = EBrickState::All;
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomRight)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopRight, EBrickState::All, m_size), onCollisionCallbackTopRight));
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomRight, EBrickState::All, m_size), onCollisionCallbackBottomRight));
+        addBrickCollider(EBrickLocation::TopRight);
+        addBrickCollider(EBrickLocation::BottomRight);
         break;
     case EBrickWallType::TopLeft:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopLeft)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopLeft, EBrickState::All, m_size), onCollisionCallbackTopLeft));
+        addBrickCollider(EBrickLocation::TopLeft);
         break;
     case EBrickWallType::TopRight:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::TopRight)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::TopRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::TopRight, EBrickState::All, m_size), onCollisionCallbackTopRight));
+        addBrickCollider(EBrickLocation::TopRight);
         break;
     case EBrickWallType::BottomLeft:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomLeft)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomLeft)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomLeft, EBrickState::All, m_size), onCollisionCallbackBottomLeft));
+        addBrickCollider(EBrickLocation::BottomLeft);
         break;
     case EBrickWallType::BottomRight:
         m_eCurrentBrickState[static_cast<size_t>(EBrickLocation::BottomRight)] = EBrickState::All;
-        m_brickLocationToColliderMap[static_cast<size_t>(EBrickLocation::BottomRight)] = &(m_colliders.emplace_back(getAABBForBrickState(EBrickLocation::BottomRight, EBrickState::All, m_size), onCollisionCallbackBottomRight));
+        addBrickCollider(EBrickLocation::BottomRight);
         break;
     }
 }
@@ -50,18 +50,61 @@ public:
 		BottomRight
 	};
 
+	// plain function pointer with the object it is called for, like the collision callbacks
+	struct DamageCallback {
+		typedef void (*Function)(void* owner, BrickWall& wall);
+
+		template <class T, void (T::*Method)(BrickWall&)>
+		static DamageCallback bind(T* owner) {
+			DamageCallback callback;
+			callback.function = [](void* owner, BrickWall& wall)
+			{
+				(static_cast<T*>(owner)->*Method)(wall);
+			};
+			callback.owner = owner;
+			return callback;
+		}
+
+		explicit operator bool() const { return function != nullptr; }
+		void operator()(BrickWall& wall) const { function(owner, wall); }
+
+		Function function = nullptr;
+		void* owner = nullptr;
+	};
+
+	static void loadSprites();
+	static void unloadSprites();
+
 	BrickWall(const EBrickWallType eBrickWallType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
 	virtual void render() const override;
+	// called every time a brick of the wall loses a part
+	void setDamageCallback(const DamageCallback callback) { m_onDamage = callback; }
+	// quarters left of the brick, bit 0 is the top left one, then top right, bottom left and bottom right
+	uint8_t getBrickQuarters(const EBrickLocation eBrickLocation) const;
+	const glm::vec2& getBrickOffset(const EBrickLocation eBrickLocation) const { return m_blockOffsets[static_cast<size_t>(eBrickLocation)]; }
+	const std::array<EBrickState, 4>& getBrickStates() const { return m_eCurrentBrickState; }
+	// puts the bricks and their colliders into the states, without calling the damage callback
+	void setBrickStates(const std::array<EBrickState, 4>& eBrickStates);
+	// the states index the lookup tables, so states read from outside are checked first
+	static bool isValidBrickState(const EBrickState eBrickState);
 
 private:
 	void renderBrick(const EBrickLocation eBrickLocation) const;
+	// lookups into tables generated at compile time
 	static EBrickState getBrickStateAfterCollision(const EBrickState currentState, const Physics::ECollisionDirection direction);
 	static Physics::AABB getAABBForBrickState(const EBrickLocation location, const EBrickState eBrickState, const glm::vec2& size);
-	void onCollisionCallback(const EBrickLocation location, const IGameObject& object, const Physics::ECollisionDirection direction);
+	void onCollisionCallback(const IGameObject& object, const Physics::ECollisionDirection direction, const uint8_t location);
+	void addBrickCollider(const EBrickLocation location);
+
+	static constexpr uint8_t NO_COLLIDER = 0xFF;
+
+	// index of the collider of every brick in m_colliders
+	std::array<uint8_t, 4> m_brickLocationToColliderMap;
 
-	std::array<Physics::Collider*, 4> m_brickLocationToColliderMap;
+	// sprites for every brick state except Destroyed, shared by all brick walls
+	static std::array<std::shared_ptr<RenderEngine::Sprite>, 15> m_sprites;
 
 	std::array<EBrickState, 4> m_eCurrentBrickState;
-	std::array<std::shared_ptr<RenderEngine::Sprite>, 15> m_sprites;
 	std::array<glm::vec2, 4> m_blockOffsets;
+	DamageCallback m_onDamage;
 };
\ No newline at end of file
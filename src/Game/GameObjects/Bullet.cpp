@@ -2,96 +2,181 @@
 
 #include "../../Resources/ResourceManager.h"
 #include "../../Renderer/Sprite.h"
+#include "../ECS/DynamicEntityWorld.h"
+
+Bullet::BulletVisuals Bullet::m_visuals;
+
+void Bullet::loadVisuals() {
+	m_visuals.sprites[static_cast<size_t>(EOrientation::Top)] = ResourceManager::getSprite("bullet_Top");
+	m_visuals.sprites[static_cast<size_t>(EOrientation::Bottom)] = ResourceManager::getSprite("bullet_Bottom");
+	m_visuals.sprites[static_cast<size_t>(EOrientation::Left)] = ResourceManager::getSprite("bullet_Left");
+	m_visuals.sprites[static_cast<size_t>(EOrientation::Right)] = ResourceManager::getSprite("bullet_Right");
+	m_visuals.sprite_explosion = ResourceManager::getSprite("explosion");
+}
+
+void Bullet::unloadVisuals() {
+	m_visuals = BulletVisuals();
+}
+
+template <class Component>
+Component& Bullet::get() const {
+	return m_world->get<Component>(m_entity);
+}
 
 Bullet::Bullet(const double velocity,
 		   const glm::vec2& position,
 		   const glm::vec2& size,
 		   const glm::vec2& explosionSize,
-		   const float layer)
+		   const float layer,
+		   TimerWheel* timerWheel,
+		   RenderEngine::AnimationSystem* animationSystem,
+		   DynamicEntityWorld* world)
 	: IGameObject(IGameObject::EObjectType::Bullet, position, size, 0.f, layer)
-	, m_explosionSize(explosionSize)
-	, m_explosionOffset((m_explosionSize - m_size) / 2.f)
-	, m_eOrientation(EOrientation::Top)
-	, m_sprite_top(ResourceManager::getSprite("bullet_Top"))
-	, m_sprite_bottom(ResourceManager::getSprite("bullet_Bottom"))
-	, m_sprite_left(ResourceManager::getSprite("bullet_Left"))
-	, m_sprite_right(ResourceManager::getSprite("bullet_Right"))
-	, m_sprite_explosion(ResourceManager::getSprite("explosion"))
-	, m_spriteAnimator_explosion(m_sprite_explosion)
-	, m_maxVelocity(velocity)
-	, m_isActive(false)
-	, m_isExplosion(false)
+	, m_world(world)
+	, m_timerWheel(timerWheel)
+	, m_animationSystem(animationSystem)
 {
-	auto onCollisionCallBack = [&](const IGameObject& object, const Physics::ECollisionDirection) {
-		setVelocity(0);
-		m_isExplosion = true;
-		m_explosionTimer.start(m_spriteAnimator_explosion.getTotalDuration());
-	};
+	Physics::ColliderList colliders;
+	colliders.emplace_back(glm::vec2(0), m_size, Physics::CollisionCallback::bind<Bullet, &Bullet::onCollision>(this));
 
-	m_colliders.emplace_back(glm::vec2(0), m_size, onCollisionCallBack);
+	m_entity = m_world->create<BulletArchetype>(ECS::Transform{ position, position, size, layer },
+												ECS::Kinematics{ glm::vec2(0, 1.f), 0, velocity },
+												ECS::Collision{ colliders },
+												State{ ECS::Entity(), EOrientation::Top, false, false },
+												Explosion{ explosionSize, (explosionSize - size) / 2.f, m_animationSystem->create(m_visuals.sprite_explosion, false), TimerWheel::Handle() });
+}
 
-	m_explosionTimer.setCallback([&]()
-		{
-			m_isExplosion = false;
-			m_isActive = false;
-			m_spriteAnimator_explosion.reset();
-		}
-	);
+Bullet::~Bullet() {
+	Explosion& explosion = get<Explosion>();
+	m_timerWheel->cancel(explosion.timer);
+	m_animationSystem->destroy(explosion.animation);
+	m_world->destroy(m_entity);
 }
 
-void Bullet::render() const {
-	if (m_isExplosion) {
-		switch (m_eOrientation)
+glm::vec2& Bullet::getCurrentPosition() {
+	return get<ECS::Transform>().position;
+}
+
+glm::vec2& Bullet::getTargetPosition() {
+	return get<ECS::Transform>().targetPosition;
+}
+
+glm::vec2& Bullet::getCurrentDirection() {
+	return get<ECS::Kinematics>().direction;
+}
+
+double Bullet::getCurrentVelocity() {
+	return get<ECS::Kinematics>().velocity;
+}
+
+void Bullet::setVelocity(const double velocity) {
+	get<ECS::Kinematics>().velocity = velocity;
+}
+
+const Physics::ColliderList& Bullet::getColliders() const {
+	return get<ECS::Collision>().colliders;
+}
+
+bool Bullet::isActive() const {
+	return get<State>().isActive;
+}
+
+bool Bullet::isExploding() const {
+	return get<State>().isExplosion;
+}
+
+void Bullet::onCollision(const IGameObject&, const Physics::ECollisionDirection, const uint8_t) {
+	State& state = get<State>();
+	if (state.isExplosion) {
+		return;
+	}
+	setVelocity(0);
+	state.isExplosion = true;
+
+	Explosion& explosion = get<Explosion>();
+	m_animationSystem->setPlaying(explosion.animation, true);
+	m_timerWheel->cancel(explosion.timer);
+	explosion.timer = m_timerWheel->schedule(m_animationSystem->getTotalDuration(explosion.animation), TimerWheel::Callback::bind<Bullet, &Bullet::onExplosionTimer>(this));
+}
+
+void Bullet::restoreState() {
+	m_entity = m_world->getEntity(m_entity.index);
+	m_timerWheel->setCallback(get<Explosion>().timer, TimerWheel::Callback::bind<Bullet, &Bullet::onExplosionTimer>(this));
+}
+
+void Bullet::onExplosionTimer() {
+	State& state = get<State>();
+	state.isExplosion = false;
+	state.isActive = false;
+
+	const Explosion& explosion = get<Explosion>();
+	m_animationSystem->reset(explosion.animation);
+	m_animationSystem->setPlaying(explosion.animation, false);
+}
+
+void Bullet::renderEntity(const ECS::Transform& transform, const State& state, const Explosion& explosion, const RenderEngine::AnimationSystem& animationSystem) {
+	if (state.isExplosion) {
+		const glm::vec2 position = transform.position - explosion.offset;
+		const size_t frame = animationSystem.getCurrentFrame(explosion.animation);
+		switch (state.eOrientation)
 		{
 		case EOrientation::Top:
-			m_sprite_explosion->render(m_position - m_explosionOffset + glm::vec2(0, m_size.y / 2.f), m_explosionSize, m_rotation, m_layer + 0.1f, m_spriteAnimator_explosion.getCurrentFrame());
+			m_visuals.sprite_explosion->render(position + glm::vec2(0, transform.size.y / 2.f), explosion.size, 0.f, transform.layer + 0.1f, frame);
 			break;
 		case EOrientation::Bottom:
-			m_sprite_explosion->render(m_position - m_explosionOffset - glm::vec2(0, m_size.y / 2.f), m_explosionSize, m_rotation, m_layer + 0.1f, m_spriteAnimator_explosion.getCurrentFrame());
+			m_visuals.sprite_explosion->render(position - glm::vec2(0, transform.size.y / 2.f), explosion.size, 0.f, transform.layer + 0.1f, frame);
 			break;
 		case EOrientation::Left:
-			m_sprite_explosion->render(m_position - m_explosionOffset - glm::vec2(m_size.x / 2.f, 0), m_explosionSize, m_rotation, m_layer + 0.1f, m_spriteAnimator_explosion.getCurrentFrame());
+			m_visuals.sprite_explosion->render(position - glm::vec2(transform.size.x / 2.f, 0), explosion.size, 0.f, transform.layer + 0.1f, frame);
 			break;
 		case EOrientation::Right:
-			m_sprite_explosion->render(m_position - m_explosionOffset + glm::vec2(m_size.x / 2.f, 0), m_explosionSize, m_rotation, m_layer + 0.1f, m_spriteAnimator_explosion.getCurrentFrame());
+			m_visuals.sprite_explosion->render(position + glm::vec2(transform.size.x / 2.f, 0), explosion.size, 0.f, transform.layer + 0.1f, frame);
 			break;
 		}
 	}
-	else if (m_isActive) {
-		switch (m_eOrientation)
+	else if (state.isActive) {
+		m_visuals.sprites[static_cast<size_t>(state.eOrientation)]->render(transform.position, transform.size, 0.f, transform.layer);
+	}
+}
+
+void Bullet::renderAll(const DynamicEntityWorld& world, const RenderEngine::AnimationSystem& animationSystem) {
+	world.forEach<ECS::Transform, State, Explosion>([&animationSystem](const ECS::Transform& transform, const State& state, const Explosion& explosion)
 		{
-		case EOrientation::Top:
-			m_sprite_top->render(m_position, m_size, m_rotation, m_layer);
-			break;
-		case EOrientation::Bottom:
-			m_sprite_bottom->render(m_position, m_size, m_rotation, m_layer);
-			break;
-		case EOrientation::Left:
-			m_sprite_left->render(m_position, m_size, m_rotation, m_layer);
-			break;
-		case EOrientation::Right:
-			m_sprite_right->render(m_position, m_size, m_rotation, m_layer);
-			break;
+			renderEntity(transform, state, explosion, animationSystem);
 		}
-	}
+	);
 }
 
-void Bullet::update(const double delta) {
-	if (m_isExplosion) {
-		m_spriteAnimator_explosion.update(delta);
-		m_explosionTimer.update(delta);
-	}
+void Bullet::render() const {
+	renderEntity(get<ECS::Transform>(), get<State>(), get<Explosion>(), *m_animationSystem);
 }
 
-void Bullet::fire(const glm::vec2& position, const glm::vec2& direction) {
-	m_position = position;
-	m_direction = direction;
-	if (m_direction.x == 0.f) {
-		m_eOrientation = (m_direction.y < 0) ? EOrientation::Bottom : EOrientation::Top;
+void Bullet::fire(const ECS::Entity& shooter, const glm::vec2& position, const glm::vec2& direction) {
+	get<ECS::Transform>().position = position;
+	ECS::Kinematics& kinematics = get<ECS::Kinematics>();
+	kinematics.direction = direction;
+
+	State& state = get<State>();
+	state.shooter = shooter;
+	if (direction.x == 0.f) {
+		state.eOrientation = (direction.y < 0) ? EOrientation::Bottom : EOrientation::Top;
 	}
 	else {
-		m_eOrientation = (m_direction.x < 0) ? EOrientation::Left : EOrientation::Right;
+		state.eOrientation = (direction.x < 0) ? EOrientation::Left : EOrientation::Right;
 	}
-	m_isActive = true;
-	setVelocity(m_maxVelocity);
-}
\ No newline at end of file
+	state.isActive = true;
+	setVelocity(kinematics.maxVelocity);
+}
+
+const ECS::Entity& Bullet::getShooter() const {
+	return get<State>().shooter;
+}
+
+bool Bullet::isShotByPlayer() const {
+	const ECS::Entity& shooter = get<State>().shooter;
+	return m_world->isAlive(shooter) && !m_world->get<ECS::AIController>(shooter).component;
+}
+
+bool Bullet::isOwnedBy(const IGameObject& object) const {
+	return object.getObjectType() == IGameObject::EObjectType::Tank && static_cast<const Tank&>(object).getEntity() == get<State>().shooter;
+}
@@ -1,8 +1,10 @@
 #pragma once
 
 #include "IGameObject.h"
-#include "../../Renderer/SpriteAnimator.h"
-#include "../../System/Timer.h"
+#include "../../Renderer/AnimationSystem.h"
+#include "../../System/TimerWheel.h"
+#include "../ECS/EntityWorld.h"
+#include "../ECS/Components.h"
 
 #include <array>
 #include <memory>
@@ -11,6 +13,8 @@ namespace RenderEngine {
 	class Sprite;
 }
 
+class DynamicEntityWorld;
+
 class Bullet : public IGameObject {
 public:
 	enum class EOrientation : uint8_t {
@@ -20,29 +24,78 @@ public:
 		Right
 	};
 
+	// sprites shared by all bullets
+	struct BulletVisuals {
+		std::array<std::shared_ptr<RenderEngine::Sprite>, 4> sprites;
+		std::shared_ptr<RenderEngine::Sprite> sprite_explosion;
+	};
+
+	// components of a bullet entity besides the common ones
+	struct State {
+		// the tank that fired the bullet, it stops matching once that tank is destroyed and recycled
+		ECS::Entity shooter;
+		EOrientation eOrientation;
+		bool isActive;
+		bool isExplosion;
+	};
+
+	struct Explosion {
+		glm::vec2 size;
+		glm::vec2 offset;
+		RenderEngine::AnimationSystem::Handle animation;
+		TimerWheel::Handle timer;
+	};
+
+	static void loadVisuals();
+	static void unloadVisuals();
+	// draws every active bullet of the world in one pass over its components
+	static void renderAll(const DynamicEntityWorld& world, const RenderEngine::AnimationSystem& animationSystem);
+
+	// the bullet is a handle to an entity of the world, its data lives in the component arrays
 	Bullet(const double velocity,
 		const glm::vec2& position, 
 		const glm::vec2& size,
 		const glm::vec2& explosionSize,
-		const float layer);
+		const float layer,
+		TimerWheel* timerWheel,
+		RenderEngine::AnimationSystem* animationSystem,
+		DynamicEntityWorld* world);
+	~Bullet();
 
 	virtual void render() const override;
-	void update(const double delta) override;
-	bool isActive() const { return m_isActive; }
-	void fire(const glm::vec2& position, const glm::vec2& direction);
+	bool isActive() const;
+	bool isExploding() const;
+	void fire(const ECS::Entity& shooter, const glm::vec2& position, const glm::vec2& direction);
+	const ECS::Entity& getShooter() const;
+	// the shooter is a player tank that is still on the level
+	bool isShotByPlayer() const;
+
+	glm::vec2& getCurrentPosition() override;
+	glm::vec2& getTargetPosition() override;
+	glm::vec2& getCurrentDirection() override;
+	double getCurrentVelocity() override;
+	void setVelocity(const double velocity) override;
+	const Physics::ColliderList& getColliders() const override;
+	bool isOwnedBy(const IGameObject& object) const override;
+
+	const ECS::Entity& getEntity() const { return m_entity; }
+	// the components are restored with the entity world and the timers, the bullet takes the restored
+	// generation of its entity and binds the explosion timer again
+	void restoreState();
 
 private:
-	glm::vec2 m_explosionSize;
-	glm::vec2 m_explosionOffset;
-	EOrientation m_eOrientation;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_top;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_bottom;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_left;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_right;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_explosion;
-	RenderEngine::SpriteAnimator m_spriteAnimator_explosion;
-	Timer m_explosionTimer;
-	double m_maxVelocity;
-	bool m_isActive;
-	bool m_isExplosion;
+	template <class Component>
+	Component& get() const;
+
+	static void renderEntity(const ECS::Transform& transform, const State& state, const Explosion& explosion, const RenderEngine::AnimationSystem& animationSystem);
+
+	void onCollision(const IGameObject& object, const Physics::ECollisionDirection direction, const uint8_t);
+	void onExplosionTimer();
+
+	static BulletVisuals m_visuals;
+
+	DynamicEntityWorld* m_world;
+	ECS::Entity m_entity;
+	TimerWheel* m_timerWheel;
+	RenderEngine::AnimationSystem* m_animationSystem;
 };
\ No newline at end of file
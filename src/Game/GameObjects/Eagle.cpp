@@ -17,8 +17,4 @@ Eagle::Eagle(const glm::vec2& position, const glm::vec2& size, const float rotat
 
 void Eagle::render() const {
 	m_sprite[static_cast<size_t>(m_eCurrentState)]->render(m_position, m_size, m_rotation, m_layer);
-}
-
-void Eagle::update(const double delta) {
-
 }
\ No newline at end of file
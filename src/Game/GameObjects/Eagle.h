@@ -18,7 +18,6 @@ public:
 
 	Eagle(const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
 	virtual void render() const override;
-	virtual void update(const double delta) override;
 
 private:
 	std::array<std::shared_ptr<RenderEngine::Sprite>, 2> m_sprite;
@@ -1,15 +1,21 @@
 #include "IGameObject.h"
 
+#include "../../System/Snapshot.h"
+
 IGameObject::IGameObject(const EObjectType objectType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer)
-	: m_owner(nullptr)
-	, m_position(position)
+	: m_position(position)
 	, m_targetPosition(m_position)
 	, m_size(size)
 	, m_rotation(rotation)
 	, m_layer(layer)
 	, m_objectType(objectType)
+	, m_tickPhases(0)
 	, m_direction(0, 1.f)
 	, m_velocity(0)
+	, m_eSimulationLOD(ESimulationLOD::Full)
+	, m_pendingSimulationTime(0)
+	, m_simulationStep(0)
+	, m_physicsIndex(INVALID_PHYSICS_INDEX)
 {
 
 }
@@ -18,10 +24,63 @@ IGameObject::~IGameObject() {
 
 }
 
-void IGameObject::setOwner(IGameObject* owner) {
-	m_owner = owner;
-}
-
 void IGameObject::setVelocity(const double velocity) {
 	m_velocity = velocity;
+}
+
+void IGameObject::tick(const ETickPhase eTickPhase, const double delta) {
+	switch (eTickPhase)
+	{
+	case ETickPhase::PrePhysics:
+		update(delta);
+		break;
+	case ETickPhase::PostPhysics:
+		postPhysicsUpdate(delta);
+		break;
+	default:
+		break;
+	}
+}
+
+void IGameObject::setSimulationLOD(const ESimulationLOD eSimulationLOD) {
+	if (m_eSimulationLOD != eSimulationLOD) {
+		m_eSimulationLOD = eSimulationLOD;
+		m_pendingSimulationTime = 0;
+		onSimulationLODChanged();
+	}
+}
+
+// returns the time the object has to simulate this tick, 0 if the tick is skipped
+double IGameObject::advanceSimulationClock(const double delta) {
+	if (m_eSimulationLOD == ESimulationLOD::Full) {
+		m_simulationStep = delta;
+		return m_simulationStep;
+	}
+
+	m_pendingSimulationTime += delta;
+	if (m_pendingSimulationTime >= REDUCED_LOD_STEP) {
+		m_simulationStep = m_pendingSimulationTime;
+		m_pendingSimulationTime = 0;
+	}
+	else {
+		m_simulationStep = 0;
+	}
+	return m_simulationStep;
+}
+
+void IGameObject::saveSimulationClock(SnapshotWriter& writer) const {
+	writer.write(m_eSimulationLOD);
+	writer.write(m_pendingSimulationTime);
+	writer.write(m_simulationStep);
+}
+
+bool IGameObject::readSimulationClock(SnapshotReader& reader, SimulationClock& clock) const {
+	return reader.read(clock.eSimulationLOD) && reader.read(clock.pendingSimulationTime) && reader.read(clock.simulationStep)
+		&& clock.eSimulationLOD <= ESimulationLOD::Reduced;
+}
+
+void IGameObject::restoreSimulationClock(const SimulationClock& clock) {
+	m_eSimulationLOD = clock.eSimulationLOD;
+	m_pendingSimulationTime = clock.pendingSimulationTime;
+	m_simulationStep = clock.simulationStep;
 }
\ No newline at end of file
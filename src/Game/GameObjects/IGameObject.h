@@ -1,9 +1,13 @@
 #pragma once
 
 #include <glm/vec2.hpp>
+#include <limits>
 
 #include "../../Physics/PhysicsEngine.h"
 
+class SnapshotWriter;
+class SnapshotReader;
+
 class IGameObject {
 public:
 	enum class EObjectType {
@@ -20,13 +24,32 @@ public:
 		Unknown
 	};
 
-	IGameObject(const EObjectType objectType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
+	enum class ESimulationLOD : uint8_t {
+		Full,
+		Reduced
+	};
+
+	// update phases an object can opt into, run by the level in this order every tick
+	enum class ETickPhase : uint8_t {
+		PrePhysics,
+		PostPhysics,
 
-	void setOwner(IGameObject* owner);
-	IGameObject* getOwner() const { return m_owner; }
+		Count
+	};
+
+	static constexpr size_t INVALID_PHYSICS_INDEX = std::numeric_limits<size_t>::max();
+
+	// objects at reduced LOD accumulate time and simulate in steps of at least this length (ms)
+	static constexpr double REDUCED_LOD_STEP = 64.0;
+
+	IGameObject(const EObjectType objectType, const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
 
 	virtual void render() const = 0;
 	virtual void update(const double delta) {};
+	virtual void postPhysicsUpdate(const double) {}
+
+	bool ticksIn(const ETickPhase eTickPhase) const { return m_tickPhases & (1 << static_cast<uint8_t>(eTickPhase)); }
+	void tick(const ETickPhase eTickPhase, const double delta);
 
 	virtual ~IGameObject();
 
@@ -37,20 +60,47 @@ public:
 	virtual void setVelocity(const double velocity);
 
 	const glm::vec2& getSize() const { return m_size; }
-	const std::vector<Physics::Collider>& getColliders() const { return m_colliders; }
+	virtual const Physics::ColliderList& getColliders() const { return m_colliders; }
 	EObjectType getObjectType() const { return m_objectType; }
 	virtual bool collides(const EObjectType objectType) { return true; }
+	// the physics doesn't collide the object with its owner, such as a bullet with the tank that fired it
+	virtual bool isOwnedBy(const IGameObject&) const { return false; }
+
+	void setSimulationLOD(const ESimulationLOD eSimulationLOD);
+	ESimulationLOD getSimulationLOD() const { return m_eSimulationLOD; }
+	double advanceSimulationClock(const double delta);
+	double getSimulationDelta(const double delta) const { return m_eSimulationLOD == ESimulationLOD::Full ? delta : m_simulationStep; }
+	// the simulation LOD and its clock as a snapshot holds them
+	struct SimulationClock {
+		ESimulationLOD eSimulationLOD = ESimulationLOD::Full;
+		double pendingSimulationTime = 0;
+		double simulationStep = 0;
+	};
+	void saveSimulationClock(SnapshotWriter& writer) const;
+	bool readSimulationClock(SnapshotReader& reader, SimulationClock& clock) const;
+	void restoreSimulationClock(const SimulationClock& clock);
 	
 protected:
-	IGameObject* m_owner;
+	virtual void onSimulationLODChanged() {}
+	void registerTickPhase(const ETickPhase eTickPhase) { m_tickPhases |= 1 << static_cast<uint8_t>(eTickPhase); }
+
 	glm::vec2 m_position;
 	glm::vec2 m_targetPosition;
 	glm::vec2 m_size;
 	float m_rotation;
 	float m_layer;
 	EObjectType m_objectType;
+	uint8_t m_tickPhases;
 
 	glm::vec2 m_direction;
 	double m_velocity;
-	std::vector<Physics::Collider> m_colliders;
+	Physics::ColliderList m_colliders;
+
+	ESimulationLOD m_eSimulationLOD;
+	double m_pendingSimulationTime;
+	double m_simulationStep;
+
+private:
+	friend class Physics::PhysicsEngine;
+	size_t m_physicsIndex;
 };
\ No newline at end of file
@@ -3,13 +3,42 @@
 #include "../../Resources/ResourceManager.h"
 #include "../../Renderer/Sprite.h"
 #include "Bullet.h"
+#include "../BulletPool.h"
 #include "../../Physics/PhysicsEngine.h"
 #include "../AIComponent.h"
+#include "../ECS/DynamicEntityWorld.h"
+#include "../../System/Snapshot.h"
+
+#include <algorithm>
+
+std::array<Tank::TankVisuals, Tank::TANK_TYPES_COUNT> Tank::m_visuals;
 
 const std::string& Tank::getTankSpriteFromType(const ETankType eType) {
 	return TankTypeToSpriteString[static_cast<size_t>(eType)];
 }
 
+void Tank::loadVisuals() {
+	for (size_t currentType = 0; currentType < TANK_TYPES_COUNT; ++currentType) {
+		const std::string& spriteName = getTankSpriteFromType(static_cast<ETankType>(currentType));
+		TankVisuals& visuals = m_visuals[currentType];
+		visuals.sprites[static_cast<size_t>(EOrientation::Top)] = ResourceManager::getSprite(spriteName + "_top");
+		visuals.sprites[static_cast<size_t>(EOrientation::Bottom)] = ResourceManager::getSprite(spriteName + "_bottom");
+		visuals.sprites[static_cast<size_t>(EOrientation::Left)] = ResourceManager::getSprite(spriteName + "_left");
+		visuals.sprites[static_cast<size_t>(EOrientation::Right)] = ResourceManager::getSprite(spriteName + "_right");
+		visuals.sprite_respawn = ResourceManager::getSprite("respawn");
+		visuals.sprite_shield = ResourceManager::getSprite("shield");
+	}
+}
+
+void Tank::unloadVisuals() {
+	m_visuals.fill(TankVisuals());
+}
+
+template <class Component>
+Component& Tank::get() const {
+	return m_world->get<Component>(m_entity);
+}
+
 Tank::Tank(const Tank::ETankType eType,
 		   const bool bHasAI,
 		   const bool bShieldOnSpawn,
@@ -17,164 +46,338 @@ Tank::Tank(const Tank::ETankType eType,
 		   const double maxVelocity,
 		   const glm::vec2& position,
 		   const glm::vec2& size,
-		   const float layer)
+		   const float layer,
+		   BulletPool* bulletPool,
+		   TimerWheel* timerWheel,
+		   RenderEngine::AnimationSystem* animationSystem,
+		   DynamicEntityWorld* world)
 	: IGameObject(IGameObject::EObjectType::Tank, position, size, 0.f, layer)
-	, m_eOrientation(eOrientation)
-	, m_currentBullet(std::make_shared<Bullet>(0.1, m_position + m_size / 4.f, m_size / 2.f, m_size, layer))
-	, m_sprite_top(ResourceManager::getSprite(getTankSpriteFromType(eType) + "_top"))
-	, m_sprite_bottom(ResourceManager::getSprite(getTankSpriteFromType(eType) + "_bottom"))
-	, m_sprite_left(ResourceManager::getSprite(getTankSpriteFromType(eType) + "_left"))
-	, m_sprite_right(ResourceManager::getSprite(getTankSpriteFromType(eType) + "_right"))
-	, m_spriteAnimator_top(m_sprite_top)
-	, m_spriteAnimator_bottom(m_sprite_bottom)
-	, m_spriteAnimator_left(m_sprite_left)
-	, m_spriteAnimator_right(m_sprite_right)
-	, m_sprite_respawn(ResourceManager::getSprite("respawn"))
-	, m_spriteAnimator_respawn(m_sprite_respawn)
-	, m_sprite_shield(ResourceManager::getSprite("shield"))
-	, m_spriteAnimator_shield(m_sprite_shield)
-	, m_maxVelocity(maxVelocity)
-	, m_isSpawning(true)
-	, m_hasShield(false)
-	, m_bShieldOnSpawn(bShieldOnSpawn)
+	, m_world(world)
+	, m_timerWheel(timerWheel)
+	, m_animationSystem(animationSystem)
 {
-	setOrientation(m_eOrientation);
+	const TankVisuals& visuals = getVisuals(eType);
+	Animations animations;
+	for (size_t currentOrientation = 0; currentOrientation < animations.movement.size(); ++currentOrientation) {
+		animations.movement[currentOrientation] = m_animationSystem->create(visuals.sprites[currentOrientation], false);
+	}
+	animations.respawn = m_animationSystem->create(visuals.sprite_respawn, false);
+	animations.shield = m_animationSystem->create(visuals.sprite_shield, false);
 
-	m_respawnTimer.setCallback([&]()
-		{
-			m_isSpawning = false;
-			if (m_AIComponent) {
-				m_velocity = m_maxVelocity;
-			}
+	Physics::ColliderList colliders;
+	colliders.emplace_back(glm::vec2(0), m_size, Physics::CollisionCallback::bind<Tank, &Tank::onCollision>(this));
+
+	m_entity = m_world->create<TankArchetype>(ECS::Transform{ position, position, size, layer },
+											  ECS::Kinematics{ glm::vec2(0, 1.f), 0, maxVelocity },
+											  ECS::Collision{ colliders },
+											  ECS::Weapon{ bulletPool, {}, 0 },
+											  ECS::AIController{ nullptr },
+											  State{ eType, eOrientation, eOrientation, true, true, false, bShieldOnSpawn, false },
+											  std::move(animations),
+											  Timers());
+
+	registerTickPhase(ETickPhase::PrePhysics);
+
+	setMaxBullets(1);
 
-			if (m_bShieldOnSpawn) {
-				m_hasShield = true;
-				m_shieldTimer.start(2000);
+	if (bHasAI) {
+		m_AIComponent = std::make_unique<AIComponent>(this);
+		get<ECS::AIController>().component = m_AIComponent.get();
+	}
+
+	reset(eType, position);
+}
+
+Tank::~Tank() {
+	Timers& timers = get<Timers>();
+	m_timerWheel->cancel(timers.respawn);
+	m_timerWheel->cancel(timers.shield);
+
+	Animations& animations = get<Animations>();
+	for (auto& animation : animations.movement) {
+		m_animationSystem->destroy(animation);
+	}
+	m_animationSystem->destroy(animations.respawn);
+	m_animationSystem->destroy(animations.shield);
+
+	m_world->destroy(m_entity);
+}
+
+glm::vec2& Tank::getCurrentPosition() {
+	return get<ECS::Transform>().position;
+}
+
+glm::vec2& Tank::getTargetPosition() {
+	return get<ECS::Transform>().targetPosition;
+}
+
+glm::vec2& Tank::getCurrentDirection() {
+	return get<ECS::Kinematics>().direction;
+}
+
+double Tank::getCurrentVelocity() {
+	return get<ECS::Kinematics>().velocity;
+}
+
+double Tank::getMaxVelocity() const {
+	return get<ECS::Kinematics>().maxVelocity;
+}
+
+const Physics::ColliderList& Tank::getColliders() const {
+	return get<ECS::Collision>().colliders;
+}
+
+size_t Tank::getMaxBullets() const {
+	return get<ECS::Weapon>().maxBullets;
+}
+
+bool Tank::isDestroyed() const {
+	return get<State>().isDestroyed;
+}
+
+bool Tank::isSpawning() const {
+	return get<State>().isSpawning;
+}
+
+bool Tank::hasShield() const {
+	return get<State>().hasShield;
+}
+
+void Tank::reset(const ETankType eType, const glm::vec2& spawnPoint) {
+	// bullets of the previous life no longer belong to the tank
+	m_world->renew(m_entity);
+
+	ECS::Transform& transform = get<ECS::Transform>();
+	transform.position = spawnPoint;
+	transform.targetPosition = spawnPoint;
+	get<ECS::Kinematics>().velocity = 0;
+	get<ECS::Weapon>().bullets.clear();
+
+	State& state = get<State>();
+	state.eType = eType;
+	state.isActive = true;
+	state.isSpawning = true;
+	state.hasShield = false;
+	state.isDestroyed = false;
+	setSimulationLOD(ESimulationLOD::Full);
+
+	const TankVisuals& visuals = getVisuals(eType);
+	const Animations& animations = get<Animations>();
+	for (size_t currentOrientation = 0; currentOrientation < animations.movement.size(); ++currentOrientation) {
+		m_animationSystem->setSprite(animations.movement[currentOrientation], visuals.sprites[currentOrientation]);
+	}
+	m_animationSystem->reset(animations.respawn);
+	m_animationSystem->reset(animations.shield);
+
+	Timers& timers = get<Timers>();
+	m_timerWheel->cancel(timers.shield);
+	m_timerWheel->cancel(timers.respawn);
+	timers.respawn = m_timerWheel->schedule(1500, TimerWheel::Callback::bind<Tank, &Tank::onRespawnTimer>(this));
+
+	setOrientation(state.eSpawnOrientation);
+}
+
+void Tank::despawn() {
+	Timers& timers = get<Timers>();
+	m_timerWheel->cancel(timers.respawn);
+	m_timerWheel->cancel(timers.shield);
+	get<ECS::Kinematics>().velocity = 0;
+	get<State>().isActive = false;
+
+	const Animations& animations = get<Animations>();
+	for (const auto& animation : animations.movement) {
+		m_animationSystem->setPlaying(animation, false);
+	}
+	m_animationSystem->setPlaying(animations.respawn, false);
+	m_animationSystem->setPlaying(animations.shield, false);
+	if (m_AIComponent) {
+		m_AIComponent->unschedule();
+	}
+}
+
+void Tank::saveState(SnapshotWriter& writer) const {
+	saveSimulationClock(writer);
+	if (m_AIComponent) {
+		m_AIComponent->saveState(writer);
+	}
+}
+
+bool Tank::readState(SnapshotReader& reader, SavedState& state) const {
+	return readSimulationClock(reader, state.clock) && (!m_AIComponent || m_AIComponent->readState(reader, state.ai));
+}
+
+void Tank::restoreState(const SavedState& state, AIScheduler& scheduler) {
+	// the generations are restored with the entity world
+	m_entity = m_world->getEntity(m_entity.index);
+	restoreSimulationClock(state.clock);
+	if (m_AIComponent) {
+		m_AIComponent->restoreState(state.ai, scheduler);
+	}
+
+	const Timers& timers = get<Timers>();
+	m_timerWheel->setCallback(timers.respawn, TimerWheel::Callback::bind<Tank, &Tank::onRespawnTimer>(this));
+	m_timerWheel->setCallback(timers.shield, TimerWheel::Callback::bind<Tank, &Tank::onShieldTimer>(this));
+
+	// only the bullets still in flight are ever counted, so they are all the weapon needs
+	ECS::Weapon& weapon = get<ECS::Weapon>();
+	weapon.bullets.clear();
+	if (weapon.bulletPool) {
+		for (size_t currentBullet = 0; currentBullet < weapon.bulletPool->getActiveCount(); ++currentBullet) {
+			Bullet& bullet = weapon.bulletPool->getActiveBullet(currentBullet);
+			if (bullet.isActive() && bullet.getShooter() == m_entity) {
+				weapon.bullets.push_back(&bullet);
 			}
 		}
-	);
-	m_respawnTimer.start(1500);
+	}
+}
 
-	m_shieldTimer.setCallback([&]()
-		{
-			m_hasShield = false;
-		}
-	);
+void Tank::onCollision(const IGameObject& object, const Physics::ECollisionDirection, const uint8_t) {
+	State& state = get<State>();
+	if (object.getObjectType() != IGameObject::EObjectType::Bullet || state.isSpawning || state.hasShield || state.isDestroyed) {
+		return;
+	}
+	if (static_cast<const Bullet&>(object).isExploding()) {
+		return;
+	}
+
+	// only enemies can be destroyed for now, and only by bullets of the players
+	if (hasAI() && static_cast<const Bullet&>(object).isShotByPlayer()) {
+		state.isDestroyed = true;
+		get<ECS::Kinematics>().velocity = 0;
+	}
+}
 
-	m_colliders.emplace_back(glm::vec2(0), m_size);
+void Tank::onRespawnTimer() {
+	State& state = get<State>();
+	state.isSpawning = false;
+	if (m_AIComponent) {
+		ECS::Kinematics& kinematics = get<ECS::Kinematics>();
+		kinematics.velocity = kinematics.maxVelocity;
+	}
 
-	m_currentBullet->setOwner(this);
+	if (state.bShieldOnSpawn) {
+		state.hasShield = true;
+		get<Timers>().shield = m_timerWheel->schedule(2000, TimerWheel::Callback::bind<Tank, &Tank::onShieldTimer>(this));
+	}
+	updateAnimationState();
+}
 
-	Physics::PhysicsEngine::addDynamicGameObject(m_currentBullet);
+void Tank::onShieldTimer() {
+	get<State>().hasShield = false;
+	updateAnimationState();
+}
 
-	if (bHasAI) {
-		m_AIComponent = std::make_unique<AIComponent>(this);
+void Tank::updateAnimationState() {
+	const State& state = get<State>();
+	const Animations& animations = get<Animations>();
+	// animation is cosmetic and is paused at reduced simulation LOD
+	const bool isAnimated = m_eSimulationLOD == ESimulationLOD::Full;
+	const bool isMoving = isAnimated && !state.isSpawning && get<ECS::Kinematics>().velocity > 0;
+	for (size_t currentOrientation = 0; currentOrientation < animations.movement.size(); ++currentOrientation) {
+		m_animationSystem->setPlaying(animations.movement[currentOrientation], isMoving && currentOrientation == static_cast<size_t>(state.eOrientation));
+	}
+	m_animationSystem->setPlaying(animations.respawn, isAnimated && state.isSpawning);
+	m_animationSystem->setPlaying(animations.shield, isAnimated && !state.isSpawning && state.hasShield);
+}
+
+void Tank::onSimulationLODChanged() {
+	if (get<State>().isActive) {
+		updateAnimationState();
 	}
 }
 
 void Tank::setVelocity(const double velocity) {
-	if (!m_isSpawning) {
-		m_velocity = velocity;
+	if (!get<State>().isSpawning) {
+		get<ECS::Kinematics>().velocity = velocity;
+		updateAnimationState();
 	}
 }
 
-void Tank::render() const {
-	if (m_isSpawning) {
-		m_sprite_respawn->render(m_position, m_size, m_rotation, m_layer, m_spriteAnimator_respawn.getCurrentFrame());
+void Tank::renderEntity(const ECS::Transform& transform, const State& state, const Animations& animations, const RenderEngine::AnimationSystem& animationSystem) {
+	const TankVisuals& visuals = getVisuals(state.eType);
+	if (state.isSpawning) {
+		visuals.sprite_respawn->render(transform.position, transform.size, 0.f, transform.layer, animationSystem.getCurrentFrame(animations.respawn));
 	}
 	else {
-		switch (m_eOrientation)
-		{
-		case Tank::EOrientation::Top:
-			m_sprite_top->render(m_position, m_size, m_rotation, m_layer, m_spriteAnimator_top.getCurrentFrame());
-			break;
-		case Tank::EOrientation::Bottom:
-			m_sprite_bottom->render(m_position, m_size, m_rotation, m_layer, m_spriteAnimator_bottom.getCurrentFrame());
-			break;
-		case Tank::EOrientation::Left:
-			m_sprite_left->render(m_position, m_size, m_rotation, m_layer, m_spriteAnimator_left.getCurrentFrame());
-			break;
-		case Tank::EOrientation::Right:
-			m_sprite_right->render(m_position, m_size, m_rotation, m_layer, m_spriteAnimator_right.getCurrentFrame());
-			break;
-		}
+		const size_t orientation = static_cast<size_t>(state.eOrientation);
+		visuals.sprites[orientation]->render(transform.position, transform.size, 0.f, transform.layer, animationSystem.getCurrentFrame(animations.movement[orientation]));
 
-		if (m_hasShield) {
-			m_sprite_shield->render(m_position, m_size, m_rotation, m_layer + 0.1f, m_spriteAnimator_shield.getCurrentFrame());
+		if (state.hasShield) {
+			visuals.sprite_shield->render(transform.position, transform.size, 0.f, transform.layer + 0.1f, animationSystem.getCurrentFrame(animations.shield));
 		}
 	}
+}
 
-	if (m_currentBullet->isActive()) {
-		m_currentBullet->render();
-	}
+void Tank::renderAll(const DynamicEntityWorld& world, const RenderEngine::AnimationSystem& animationSystem) {
+	world.forEach<ECS::Transform, State, Animations>([&animationSystem](const ECS::Transform& transform, const State& state, const Animations& animations)
+		{
+			if (state.isActive) {
+				renderEntity(transform, state, animations, animationSystem);
+			}
+		}
+	);
+}
+
+void Tank::render() const {
+	renderEntity(get<ECS::Transform>(), get<State>(), get<Animations>(), *m_animationSystem);
 }
 
 void Tank::setOrientation(const EOrientation eOrientation) {
-	m_eOrientation = eOrientation;
-	switch (m_eOrientation)
+	get<State>().eOrientation = eOrientation;
+	glm::vec2& direction = get<ECS::Kinematics>().direction;
+	switch (eOrientation)
 	{
 	case Tank::EOrientation::Top:
-		m_direction.x = 0.f;
-		m_direction.y = 1.f;
+		direction.x = 0.f;
+		direction.y = 1.f;
 		break;
 	case Tank::EOrientation::Bottom:
-		m_direction.x = 0.f;
-		m_direction.y = -1.f;
+		direction.x = 0.f;
+		direction.y = -1.f;
 		break;
 	case Tank::EOrientation::Left:
-		m_direction.x = -1.f;
-		m_direction.y = 0.f;
+		direction.x = -1.f;
+		direction.y = 0.f;
 		break;
 	case Tank::EOrientation::Right:
-		m_direction.x = 1.f;
-		m_direction.y = 0.f;
+		direction.x = 1.f;
+		direction.y = 0.f;
 		break;
 	}
+	updateAnimationState();
 }
 
-void Tank::update(const double delta) {
-	if (m_currentBullet->isActive()) {
-		m_currentBullet->update(delta);
+void Tank::update(const double) {
+	// the intent was planned by the decision pass of the level
+	if (!get<State>().isSpawning && m_AIComponent) {
+		m_AIComponent->applyIntent();
 	}
+}
+
+void Tank::setMaxBullets(const size_t maxBullets) {
+	ECS::Weapon& weapon = get<ECS::Weapon>();
+	weapon.maxBullets = maxBullets;
+	weapon.bullets.reserve(maxBullets);
+}
 
-	if (m_isSpawning) {
-		m_spriteAnimator_respawn.update(delta);
-		m_respawnTimer.update(delta);
+void Tank::fire() {
+	ECS::Weapon& weapon = get<ECS::Weapon>();
+	if (get<State>().isSpawning || !weapon.bulletPool) {
+		return;
 	}
-	else {
-		if (m_AIComponent) {
-			m_AIComponent->update(delta);
-		}
-		if (m_hasShield) {
-			m_spriteAnimator_shield.update(delta);
-			m_shieldTimer.update(delta);
-		}
 
-		if (m_velocity > 0) {
-
-			switch (m_eOrientation)
-			{
-			case Tank::EOrientation::Top:
-				m_spriteAnimator_top.update(delta);
-				break;
-			case Tank::EOrientation::Bottom:
-				m_spriteAnimator_bottom.update(delta);
-				break;
-			case Tank::EOrientation::Left:
-				m_spriteAnimator_left.update(delta);
-				break;
-			case Tank::EOrientation::Right:
-				m_spriteAnimator_right.update(delta);
-				break;
-			}
+	// bullets that exploded went back to the pool and may already belong to someone else
+	weapon.bullets.erase(std::remove_if(weapon.bullets.begin(), weapon.bullets.end(), [this](const Bullet* bullet)
+		{
+			return !bullet->isActive() || bullet->getShooter() != m_entity;
+		}), weapon.bullets.end());
+
+	if (weapon.bullets.size() < weapon.maxBullets) {
+		const ECS::Transform& transform = get<ECS::Transform>();
+		const glm::vec2 direction = get<ECS::Kinematics>().direction;
+		Bullet* bullet = weapon.bulletPool->fire(m_entity, transform.position + transform.size / 4.f + transform.size * direction / 4.f, direction);
+		if (bullet) {
+			weapon.bullets.push_back(bullet);
 		}
 	}
 }
-
-void Tank::fire() {
-	if (!m_isSpawning && !m_currentBullet->isActive()) 
-	{
-		m_currentBullet->fire(m_position + m_size / 4.f + m_size * m_direction / 4.f, m_direction);
-		Physics::PhysicsEngine::addDynamicGameObject(m_currentBullet);
-	}
-}
\ No newline at end of file
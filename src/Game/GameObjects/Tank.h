@@ -2,17 +2,27 @@
 
 #include <glm/vec2.hpp>
 #include <memory>
+#include <string>
+#include <array>
+#include <vector>
 
 #include "IGameObject.h"
-#include "../../Renderer/SpriteAnimator.h"
-#include "../../System/Timer.h"
+#include "../../Renderer/AnimationSystem.h"
+#include "../../System/TimerWheel.h"
+#include "../ECS/EntityWorld.h"
+#include "../ECS/Components.h"
+#include "../AIComponent.h"
 
 namespace RenderEngine {
 	class Sprite;
 }
 
 class Bullet;
-class AIComponent;
+class BulletPool;
+class DynamicEntityWorld;
+class AIScheduler;
+class SnapshotWriter;
+class SnapshotReader;
 
 class Tank : public IGameObject {
 public:
@@ -78,6 +88,46 @@ public:
 		Right
 	};
 
+	static constexpr size_t TANK_TYPES_COUNT = static_cast<size_t>(ETankType::EnemyRed_type4) + 1;
+
+	// sprites shared by all tanks of one type
+	struct TankVisuals {
+		std::array<std::shared_ptr<RenderEngine::Sprite>, 4> sprites;
+		std::shared_ptr<RenderEngine::Sprite> sprite_respawn;
+		std::shared_ptr<RenderEngine::Sprite> sprite_shield;
+	};
+
+	// components of a tank entity besides the common ones
+	struct State {
+		ETankType eType;
+		EOrientation eOrientation;
+		EOrientation eSpawnOrientation;
+		// false while the tank waits in a pool
+		bool isActive;
+		bool isSpawning;
+		bool hasShield;
+		bool bShieldOnSpawn;
+		bool isDestroyed;
+	};
+
+	struct Animations {
+		std::array<RenderEngine::AnimationSystem::Handle, 4> movement;
+		RenderEngine::AnimationSystem::Handle respawn;
+		RenderEngine::AnimationSystem::Handle shield;
+	};
+
+	struct Timers {
+		TimerWheel::Handle respawn;
+		TimerWheel::Handle shield;
+	};
+
+	static void loadVisuals();
+	static void unloadVisuals();
+	static const TankVisuals& getVisuals(const ETankType eType) { return m_visuals[static_cast<size_t>(eType)]; }
+	// draws every active tank of the world in one pass over its components
+	static void renderAll(const DynamicEntityWorld& world, const RenderEngine::AnimationSystem& animationSystem);
+
+	// the tank is a handle to an entity of the world, its data lives in the component arrays
 	Tank(const Tank::ETankType eType,
 		const bool bHasAI,
 		const bool bShieldOnSpawn,
@@ -85,41 +135,69 @@ public:
 		const double maxVelocity,
 		const glm::vec2& position, 
 		const glm::vec2& size,
-		const float layer);
+		const float layer,
+		BulletPool* bulletPool,
+		TimerWheel* timerWheel,
+		RenderEngine::AnimationSystem* animationSystem,
+		DynamicEntityWorld* world);
+	~Tank();
 
 	void render() const override;
 	void setOrientation(const EOrientation eOrientation);
 	void update(const double delta) override;
-	double getMaxVelocity() const { return m_maxVelocity; }
+	double getMaxVelocity() const;
 	void setVelocity(const double velocity) override;
 	void fire();
+	// number of bullets the tank can have in flight at the same time
+	void setMaxBullets(const size_t maxBullets);
+	size_t getMaxBullets() const;
+	bool hasAI() const { return m_AIComponent != nullptr; }
+	AIComponent* getAIComponent() const { return m_AIComponent.get(); }
+	bool isDestroyed() const;
+	bool isSpawning() const;
+	bool hasShield() const;
+
+	glm::vec2& getCurrentPosition() override;
+	glm::vec2& getTargetPosition() override;
+	glm::vec2& getCurrentDirection() override;
+	double getCurrentVelocity() override;
+	const Physics::ColliderList& getColliders() const override;
+
+	// respawns the tank as another type without allocating, used to recycle pooled tanks
+	void reset(const ETankType eType, const glm::vec2& spawnPoint);
+	// stops the timers and animations of a tank that leaves the level
+	void despawn();
+
+	const ECS::Entity& getEntity() const { return m_entity; }
+	// the components are restored with the entity world, the tank restores what it keeps outside of them
+	// and binds its timers again; the bullets and the AI scheduler have to be restored first
+	struct SavedState {
+		SimulationClock clock;
+		AIComponent::SavedState ai;
+	};
+	void saveState(SnapshotWriter& writer) const;
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	void restoreState(const SavedState& state, AIScheduler& scheduler);
 
 private:
-	EOrientation m_eOrientation;
-	std::shared_ptr<Bullet> m_currentBullet;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_top;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_bottom;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_left;
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_right;
-	RenderEngine::SpriteAnimator m_spriteAnimator_top;
-	RenderEngine::SpriteAnimator m_spriteAnimator_bottom;
-	RenderEngine::SpriteAnimator m_spriteAnimator_left;
-	RenderEngine::SpriteAnimator m_spriteAnimator_right;
-
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_respawn;
-	RenderEngine::SpriteAnimator m_spriteAnimator_respawn;
-
-	std::shared_ptr <RenderEngine::Sprite> m_sprite_shield;
-	RenderEngine::SpriteAnimator m_spriteAnimator_shield;
-
-	Timer m_respawnTimer;
-	Timer m_shieldTimer;
-
-	double m_maxVelocity;
-	bool m_isSpawning;
-	bool m_hasShield;
-	bool m_bShieldOnSpawn;
+	template <class Component>
+	Component& get() const;
+
+	static void renderEntity(const ECS::Transform& transform, const State& state, const Animations& animations, const RenderEngine::AnimationSystem& animationSystem);
+
+	void onCollision(const IGameObject& object, const Physics::ECollisionDirection direction, const uint8_t);
+	void onRespawnTimer();
+	void onShieldTimer();
+	// plays only the animations of what the tank currently shows
+	void updateAnimationState();
+	void onSimulationLODChanged() override;
+
+	static std::array<TankVisuals, TANK_TYPES_COUNT> m_visuals;
 
+	DynamicEntityWorld* m_world;
+	ECS::Entity m_entity;
+	TimerWheel* m_timerWheel;
+	RenderEngine::AnimationSystem* m_animationSystem;
 	std::unique_ptr<AIComponent> m_AIComponent;
 
 	static const std::string& getTankSpriteFromType(const ETankType eType);
@@ -3,10 +3,16 @@
 #include "../../Resources/ResourceManager.h"
 #include "../../Renderer/Sprite.h"
 
-Water::Water(const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer)
+Water::Water(const glm::vec2& position,
+			 const glm::vec2& size,
+			 const float rotation,
+			 const float layer,
+			 const RenderEngine::AnimationSystem* animationSystem,
+			 const RenderEngine::AnimationSystem::Handle animation)
 	: IGameObject(IGameObject::EObjectType::Water, position, size, rotation, layer)
 	, m_sprite(ResourceManager::getSprite("water"))
-	, m_spriteAnimator(m_sprite)
+	, m_animationSystem(animationSystem)
+	, m_animation(animation)
 	, m_blockOffsets {
 		glm::vec2(0, m_size.y / 2.f),
 		glm::vec2(m_size.x / 2.f, m_size.y / 2.f),
@@ -18,7 +24,7 @@ Water::Water(const glm::vec2& position, const glm::vec2& size, const float rotat
 }
 
 void Water::renderBlock(const EBlockLocation eBlockLocation) const {
-	m_sprite->render(m_position + m_blockOffsets[static_cast<size_t>(eBlockLocation)], m_size / 2.f, m_rotation, m_layer, m_spriteAnimator.getCurrentFrame());
+	m_sprite->render(m_position + m_blockOffsets[static_cast<size_t>(eBlockLocation)], m_size / 2.f, m_rotation, m_layer, m_animationSystem->getCurrentFrame(m_animation));
 }
 
 void Water::render() const {
@@ -28,10 +34,6 @@ void Water::render() const {
 	renderBlock(EBlockLocation::BottomRight);
 }
 
-void Water::update(const double delta) {
-	m_spriteAnimator.update(delta);
-}
-
 bool Water::collides(const EObjectType objectType) {
 	return objectType != IGameObject::EObjectType::Bullet;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #pragma once
 
 #include "IGameObject.h"
-#include "../../Renderer/SpriteAnimator.h"
+#include "../../Renderer/AnimationSystem.h"
 
 #include <array>
 #include <memory>
@@ -20,15 +20,21 @@ public:
 		BottomRight
 	};
 
-	Water(const glm::vec2& position, const glm::vec2& size, const float rotation, const float layer);
+	// all water tiles share one animation owned by the level
+	Water(const glm::vec2& position,
+		const glm::vec2& size,
+		const float rotation,
+		const float layer,
+		const RenderEngine::AnimationSystem* animationSystem,
+		const RenderEngine::AnimationSystem::Handle animation);
 	virtual void render() const override;
-	virtual void update(const double delta) override;
 	virtual bool collides(const EObjectType objectType) override;
 
 private:
 	void renderBlock(const EBlockLocation eBlockLocation) const;
 
 	std::shared_ptr<RenderEngine::Sprite> m_sprite;
-	RenderEngine::SpriteAnimator m_spriteAnimator;
+	const RenderEngine::AnimationSystem* m_animationSystem;
+	RenderEngine::AnimationSystem::Handle m_animation;
 	std::array<glm::vec2, 4> m_blockOffsets;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+
 class IGameState {
 public:
 	virtual void render() const = 0;
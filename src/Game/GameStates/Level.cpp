@@ -8,71 +8,150 @@
 #include "../GameObjects/Eagle.h"
 #include "../GameObjects/Border.h"
 #include "../GameObjects/Tank.h"
+#include "../GameObjects/Bullet.h"
+#include "../BulletPool.h"
+#include "../AIComponent.h"
+#include "../EnemyTankPool.h"
+#include "../../Resources/ResourceManager.h"
+#include "../../System/ThreadPool.h"
+#include "../../System/Snapshot.h"
 
 #include <GLFW/glfw3.h>
+#include <glm/common.hpp>
 
 #include <iostream>
 #include <algorithm>
 #include <cmath>
+#include <chrono>
+#include <cstring>
 
-std::shared_ptr<IGameObject> createGameObjectFromDescription(const char description, const glm::vec2& position, const glm::vec2& size, const float rotation) {
+// types of the enemy tanks in the order they spawn, repeated for the whole level
+static const std::array<Tank::ETankType, 4> ENEMY_SPAWN_ORDER = {
+	Tank::ETankType::EnemyWhite_type1,
+	Tank::ETankType::EnemyWhite_type4,
+	Tank::ETankType::EnemyWhite_type2,
+	Tank::ETankType::EnemyWhite_type3
+};
+
+static constexpr uint32_t SNAPSHOT_MAGIC = 0x4E534342;
+static constexpr uint32_t SNAPSHOT_VERSION = 3;
+
+// how snapshots refer to the tanks and bullets
+static uint32_t getEntityIndex(const IGameObject* object) {
+	if (!object) {
+		return ECS::Entity::INVALID_INDEX;
+	}
+	switch (object->getObjectType())
+	{
+	case IGameObject::EObjectType::Tank:
+		return static_cast<const Tank*>(object)->getEntity().index;
+	case IGameObject::EObjectType::Bullet:
+		return static_cast<const Bullet*>(object)->getEntity().index;
+	default:
+		return ECS::Entity::INVALID_INDEX;
+	}
+}
+
+// FNV-1a over 8 byte words and the rest byte by byte; it catches damaged snapshots, not forged ones
+static uint64_t getSnapshotChecksum(const uint8_t* data, const size_t size) {
+	uint64_t hash = 14695981039346656037ull;
+	size_t offset = 0;
+	for (; offset + sizeof(uint64_t) <= size; offset += sizeof(uint64_t)) {
+		uint64_t word;
+		std::memcpy(&word, data + offset, sizeof(word));
+		hash = (hash ^ word) * 1099511628211ull;
+	}
+	for (; offset < size; ++offset) {
+		hash = (hash ^ data[offset]) * 1099511628211ull;
+	}
+	return hash;
+}
+
+struct Level::SnapshotState {
+	uint64_t spawnedEnemyTanks = 0;
+	uint64_t destroyedEnemyTanks = 0;
+	uint64_t pendingEnemySpawns = 0;
+	TimerWheel::Handle enemySpawnTimer;
+	std::array<uint8_t, 2> hasPlayerGoal{};
+	std::array<glm::ivec2, 2> playerGoalMin{};
+	std::array<glm::ivec2, 2> playerGoalMax{};
+	std::vector<std::array<BrickWall::EBrickState, 4>> brickStates;
+	TimerWheel::SavedState timerWheel;
+	RenderEngine::AnimationSystem::SavedState animationSystem;
+	DynamicEntityWorld::SavedState entityWorld;
+	EnemyTankPool::SavedState enemyTankPool;
+	BulletPool::SavedState bulletPool;
+	// entity indices in the order of the physics engine
+	std::vector<uint32_t> dynamicObjects;
+	AIScheduler::SavedState aiScheduler;
+	// the player tanks on the level, then every tank of the enemy pool
+	std::vector<Tank::SavedState> tanks;
+};
+
+std::shared_ptr<IGameObject> createGameObjectFromDescription(const char description,
+															 const glm::vec2& position,
+															 const glm::vec2& size,
+															 const float rotation,
+															 const RenderEngine::AnimationSystem* animationSystem,
+															 const RenderEngine::AnimationSystem::Handle waterAnimation,
+															 MonotonicArena& arena) {
 	switch (description)
 	{
 	case '0':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::Right, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::Right, position, size, rotation, 0.f);
 		break;
 	case '1':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::Bottom, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::Bottom, position, size, rotation, 0.f);
 		break;
 	case '2':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::Left, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::Left, position, size, rotation, 0.f);
 		break;
 	case '3':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::Top, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::Top, position, size, rotation, 0.f);
 		break;
 	case '4':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::All, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::All, position, size, rotation, 0.f);
 		break;
 	case 'G':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::BottomLeft, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::BottomLeft, position, size, rotation, 0.f);
 		break;
 	case 'H':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::BottomRight, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::BottomRight, position, size, rotation, 0.f);
 		break;
 	case 'I':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::TopLeft, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::TopLeft, position, size, rotation, 0.f);
 		break;
 	case 'J':
-		return std::make_shared<BrickWall>(BrickWall::EBrickWallType::TopRight, position, size, rotation, 0.f);
+		return arena.makeShared<BrickWall>(BrickWall::EBrickWallType::TopRight, position, size, rotation, 0.f);
 		break;
 
 	case '5':
-		return std::make_shared<BetonWall>(BetonWall::EBetonWallType::Right, position, size, rotation, 0.f);
+		return arena.makeShared<BetonWall>(BetonWall::EBetonWallType::Right, position, size, rotation, 0.f);
 		break;
 	case '6':
-		return std::make_shared<BetonWall>(BetonWall::EBetonWallType::Bottom, position, size, rotation, 0.f);
+		return arena.makeShared<BetonWall>(BetonWall::EBetonWallType::Bottom, position, size, rotation, 0.f);
 		break;
 	case '7':
-		return std::make_shared<BetonWall>(BetonWall::EBetonWallType::Left, position, size, rotation, 0.f);
+		return arena.makeShared<BetonWall>(BetonWall::EBetonWallType::Left, position, size, rotation, 0.f);
 		break;
 	case '8':
-		return std::make_shared<BetonWall>(BetonWall::EBetonWallType::Top, position, size, rotation, 0.f);
+		return arena.makeShared<BetonWall>(BetonWall::EBetonWallType::Top, position, size, rotation, 0.f);
 		break;
 	case '9':
-		return std::make_shared<BetonWall>(BetonWall::EBetonWallType::All, position, size, rotation, 0.f);
+		return arena.makeShared<BetonWall>(BetonWall::EBetonWallType::All, position, size, rotation, 0.f);
 		break;
 
 	case 'A':
-		return std::make_shared<Water>(position, size, rotation, 0.f);
+		return arena.makeShared<Water>(position, size, rotation, 0.f, animationSystem, waterAnimation);
 		break;
 	case 'B':
-		return std::make_shared<Trees>(position, size, rotation, 1.f);
+		return arena.makeShared<Trees>(position, size, rotation, 1.f);
 		break;
 	case 'C':
-		return std::make_shared<Ice>(position, size, rotation, -1.f);
+		return arena.makeShared<Ice>(position, size, rotation, -1.f);
 		break;
 	case 'E':
-		return std::make_shared<Eagle>(position, size, rotation, 0.f);
+		return arena.makeShared<Eagle>(position, size, rotation, 0.f);
 		break;
 	case 'D':
 		return nullptr;
@@ -84,7 +163,16 @@ std::shared_ptr<IGameObject> createGameObjectFromDescription(const char descript
 }
 
 Level::Level(const std::vector<std::string>& levelDescription, const Game::EGameMode eGameMode) 
-	: m_eGameMode(eGameMode)
+	: m_arena(ARENA_BLOCK_SIZE)
+	, m_aiScheduler(AI_REPLAN_INTERVAL, AI_BUDGET, &ThreadPool::getShared())
+	, m_entityWorld(MAX_ENEMY_TANKS + 2, BULLET_POOL_CAPACITY)
+	, m_bulletPool(m_arena.makeUnique<BulletPool>(BULLET_POOL_CAPACITY, BULLET_VELOCITY, glm::vec2(BLOCK_SIZE / 2.f), glm::vec2(BLOCK_SIZE), 1.f, &m_timerWheel, &m_animationSystem, &m_entityWorld, &m_arena))
+	, m_enemyTankPool(m_arena.makeUnique<EnemyTankPool>(MAX_ENEMY_TANKS, 0.05, glm::vec2(BLOCK_SIZE), 1.f, m_bulletPool.get(), &m_timerWheel, &m_animationSystem, &m_entityWorld, &m_arena))
+	, m_eagleFlowField(&m_navigationGrid)
+	, m_playerFlowFields{ FlowField(&m_navigationGrid), FlowField(&m_navigationGrid) }
+	, m_threatMap(&m_navigationGrid)
+	, m_observationEncoder(&m_navigationGrid, MAX_ENEMY_TANKS + 2 + BULLET_POOL_CAPACITY)
+	, m_eGameMode(eGameMode)
 {
 	if (levelDescription.empty()) {
 		std::cerr << "Empty level description!" << std::endl;
@@ -92,6 +180,8 @@ Level::Level(const std::vector<std::string>& levelDescription, const Game::EGame
 
 	m_widthBlocks = levelDescription[0].length();
 	m_heightBlocks = levelDescription.size();
+	m_widthChunks = (m_widthBlocks + CHUNK_SIZE - 1) / CHUNK_SIZE;
+	m_heightChunks = (m_heightBlocks + CHUNK_SIZE - 1) / CHUNK_SIZE;
 	m_widthPixels = static_cast<unsigned int>(m_widthBlocks * BLOCK_SIZE);
 	m_heightPixels = static_cast<unsigned int>(m_heightBlocks * BLOCK_SIZE);
 
@@ -101,173 +191,834 @@ Level::Level(const std::vector<std::string>& levelDescription, const Game::EGame
 	m_enemyRespawn_2 = { BLOCK_SIZE * (m_widthBlocks / 2 + 1), BLOCK_SIZE * m_heightBlocks - BLOCK_SIZE / 2 };
 	m_enemyRespawn_3 = { BLOCK_SIZE * m_widthBlocks, BLOCK_SIZE * m_heightBlocks - BLOCK_SIZE / 2 };
 
-	m_levelObjects.reserve(m_widthBlocks * m_heightBlocks + 4);
+	m_waterAnimation = m_animationSystem.create(ResourceManager::getSprite("water"));
+
+	m_chunks.resize(m_widthChunks * m_heightChunks);
+	m_isChunkActive.assign(m_chunks.size(), false);
+
 	unsigned int currentBottomOffset = static_cast<unsigned int>(BLOCK_SIZE * (m_heightBlocks - 1) + BLOCK_SIZE / 2.f);
-	for (const std::string& currentRow : levelDescription) {
+	for (size_t currentRow = 0; currentRow < m_heightBlocks; ++currentRow) {
 		unsigned int currentLeftOffset = BLOCK_SIZE;
-		for (const char currentElement : currentRow) {
+		for (size_t currentColumn = 0; currentColumn < m_widthBlocks; ++currentColumn) {
+			const char currentElement = levelDescription[currentRow][currentColumn];
 			switch (currentElement)
 			{
 			case 'K':
 				m_playerRespawn_1 = { currentLeftOffset, currentBottomOffset };
-				m_levelObjects.emplace_back(nullptr);
 				break;
 			case 'L':
 				m_playerRespawn_2 = { currentLeftOffset, currentBottomOffset };
-				m_levelObjects.emplace_back(nullptr);
 				break;
 			case 'M':
 				m_enemyRespawn_1 = { currentLeftOffset, currentBottomOffset };
-				m_levelObjects.emplace_back(nullptr);
 				break;
 			case 'N':
 				m_enemyRespawn_2 = { currentLeftOffset, currentBottomOffset };
-				m_levelObjects.emplace_back(nullptr);
 				break;
 			case 'O':
 				m_enemyRespawn_3 = { currentLeftOffset, currentBottomOffset };
-				m_levelObjects.emplace_back(nullptr);
 				break;
 			default:
-				m_levelObjects.emplace_back(createGameObjectFromDescription(currentElement, glm::vec2(currentLeftOffset, currentBottomOffset), glm::vec2(BLOCK_SIZE, BLOCK_SIZE), 0.f));
+			{
+				auto object = createGameObjectFromDescription(currentElement, glm::vec2(currentLeftOffset, currentBottomOffset), glm::vec2(BLOCK_SIZE, BLOCK_SIZE), 0.f, &m_animationSystem, m_waterAnimation, m_arena);
+				if (object && object->getObjectType() == IGameObject::EObjectType::BrickWall) {
+					static_cast<BrickWall&>(*object).setDamageCallback(BrickWall::DamageCallback::bind<Level, &Level::onBrickWallDamage>(this));
+					m_brickWalls.push_back(static_cast<BrickWall*>(object.get()));
+				}
+				else if (object && object->getObjectType() == IGameObject::EObjectType::Eagle) {
+					m_eaglePosition = object->getCurrentPosition();
+					m_eagleSize = object->getSize();
+				}
+				setObjectAt(currentColumn, currentRow, std::move(object));
 				break;
 			}
+			}
 
 			currentLeftOffset += BLOCK_SIZE;
 		}
 		currentBottomOffset -= BLOCK_SIZE;
 	}
 
-	// bottom border
-	m_levelObjects.emplace_back(std::make_shared<Border>(glm::vec2(BLOCK_SIZE, 0.f), glm::vec2(m_widthBlocks * BLOCK_SIZE, BLOCK_SIZE / 2), 0.f, 0.f));
+	m_borders[static_cast<size_t>(EBorder::Bottom)] = m_arena.makeShared<Border>(glm::vec2(BLOCK_SIZE, 0.f), glm::vec2(m_widthBlocks * BLOCK_SIZE, BLOCK_SIZE / 2), 0.f, 0.f);
+	m_borders[static_cast<size_t>(EBorder::Top)] = m_arena.makeShared<Border>(glm::vec2(BLOCK_SIZE, m_heightBlocks * BLOCK_SIZE + BLOCK_SIZE / 2.f), glm::vec2(m_widthBlocks * BLOCK_SIZE, BLOCK_SIZE / 2), 0.f, 0.f);
+	m_borders[static_cast<size_t>(EBorder::Left)] = m_arena.makeShared<Border>(glm::vec2(0.f, 0.f), glm::vec2(BLOCK_SIZE, (m_heightBlocks + 1) * BLOCK_SIZE), 0.f, 0.f);
+	m_borders[static_cast<size_t>(EBorder::Right)] = m_arena.makeShared<Border>(glm::vec2((m_widthBlocks + 1) * BLOCK_SIZE, 0.f), glm::vec2(BLOCK_SIZE * 2.f, (m_heightBlocks + 1) * BLOCK_SIZE), 0.f, 0.f);
+
+	buildNavigation();
+}
+
+Level::~Level() {
+
+}
+
+const std::shared_ptr<IGameObject>& Level::getObjectAt(const size_t column, const size_t row) const {
+	static const std::shared_ptr<IGameObject> emptyObject;
+
+	const auto& chunk = m_chunks[(row / CHUNK_SIZE) * m_widthChunks + column / CHUNK_SIZE];
+	if (!chunk) {
+		return emptyObject;
+	}
+	return chunk->objects[(row % CHUNK_SIZE) * CHUNK_SIZE + column % CHUNK_SIZE];
+}
+
+void Level::setObjectAt(const size_t column, const size_t row, std::shared_ptr<IGameObject> object) {
+	auto& chunk = m_chunks[(row / CHUNK_SIZE) * m_widthChunks + column / CHUNK_SIZE];
+	if (!chunk) {
+		if (!object) {
+			return;
+		}
+		chunk = m_arena.makeUnique<LevelChunk>();
+	}
+	if (object) {
+		registerTickObject(chunk->tickLists, object.get());
+	}
+	chunk->objects[(row % CHUNK_SIZE) * CHUNK_SIZE + column % CHUNK_SIZE] = std::move(object);
+}
+
+void Level::registerTickObject(TickLists& tickLists, IGameObject* object) {
+	for (size_t currentPhase = 0; currentPhase < tickLists.size(); ++currentPhase) {
+		if (object->ticksIn(static_cast<IGameObject::ETickPhase>(currentPhase))) {
+			tickLists[currentPhase].push_back(object);
+		}
+	}
+}
+
+size_t Level::runTickPhase(const TickLists& tickLists, const IGameObject::ETickPhase eTickPhase, const double delta) {
+	size_t tickedObjects = 0;
+	for (IGameObject* currentObject : tickLists[static_cast<size_t>(eTickPhase)]) {
+		const double step = currentObject->getSimulationDelta(delta);
+		if (step > 0) {
+			currentObject->tick(eTickPhase, step);
+			++tickedObjects;
+		}
+	}
+	return tickedObjects;
+}
+
+void Level::runTickPhase(const IGameObject::ETickPhase eTickPhase, const double delta) {
+	for (const size_t chunkIndex : m_activeChunks) {
+		runTickPhase(m_chunks[chunkIndex]->tickLists, eTickPhase, delta);
+	}
+	runTickPhase(m_dynamicTickLists, eTickPhase, delta);
+	m_enemyTankPool->tick(eTickPhase, delta);
+	m_bulletPool->tick(eTickPhase, delta);
+}
+
+size_t Level::getAllocatedChunksCount() const {
+	return static_cast<size_t>(std::count_if(m_chunks.begin(), m_chunks.end(), [](const auto& chunk) { return chunk != nullptr; }));
+}
+
+size_t Level::getChunkIndexAt(const glm::vec2& position) const {
+	const float column = std::clamp((position.x - BLOCK_SIZE) / BLOCK_SIZE, 0.f, static_cast<float>(m_widthBlocks - 1));
+	const float row = std::clamp((m_heightPixels - position.y + BLOCK_SIZE / 2) / BLOCK_SIZE, 0.f, static_cast<float>(m_heightBlocks - 1));
+	return (static_cast<size_t>(row) / CHUNK_SIZE) * m_widthChunks + static_cast<size_t>(column) / CHUNK_SIZE;
+}
+
+void Level::markActiveChunksAround(const glm::vec2& position) {
+	const size_t chunkIndex = getChunkIndexAt(position);
+	const size_t chunkX = chunkIndex % m_widthChunks;
+	const size_t chunkY = chunkIndex / m_widthChunks;
 
-	// top border
-	m_levelObjects.emplace_back(std::make_shared<Border>(glm::vec2(BLOCK_SIZE, m_heightBlocks * BLOCK_SIZE + BLOCK_SIZE / 2.f), glm::vec2(m_widthBlocks * BLOCK_SIZE, BLOCK_SIZE / 2), 0.f, 0.f));
+	const size_t startX = chunkX > ACTIVE_CHUNK_RADIUS ? chunkX - ACTIVE_CHUNK_RADIUS : 0;
+	const size_t endX = std::min(chunkX + ACTIVE_CHUNK_RADIUS + 1, m_widthChunks);
+	const size_t startY = chunkY > ACTIVE_CHUNK_RADIUS ? chunkY - ACTIVE_CHUNK_RADIUS : 0;
+	const size_t endY = std::min(chunkY + ACTIVE_CHUNK_RADIUS + 1, m_heightChunks);
 
-	// left border
-	m_levelObjects.emplace_back(std::make_shared<Border>(glm::vec2(0.f, 0.f), glm::vec2(BLOCK_SIZE, (m_heightBlocks + 1) * BLOCK_SIZE), 0.f, 0.f));
+	for (size_t currentChunkY = startY; currentChunkY < endY; ++currentChunkY) {
+		for (size_t currentChunkX = startX; currentChunkX < endX; ++currentChunkX) {
+			const size_t chunkIndex = currentChunkY * m_widthChunks + currentChunkX;
+			if (!m_isChunkActive[chunkIndex] && m_chunks[chunkIndex]) {
+				m_isChunkActive[chunkIndex] = true;
+				m_activeChunks.push_back(chunkIndex);
+			}
+		}
+	}
+}
 
-	// right border
-	m_levelObjects.emplace_back(std::make_shared<Border>(glm::vec2((m_widthBlocks + 1) * BLOCK_SIZE, 0.f), glm::vec2(BLOCK_SIZE * 2.f, (m_heightBlocks + 1) * BLOCK_SIZE), 0.f, 0.f));
+void Level::updateActiveChunks() {
+	for (const size_t chunkIndex : m_activeChunks) {
+		m_isChunkActive[chunkIndex] = false;
+	}
+	m_activeChunks.clear();
 
+	if (m_tank1) {
+		markActiveChunksAround(m_tank1->getCurrentPosition());
+	}
+	if (m_tank2) {
+		markActiveChunksAround(m_tank2->getCurrentPosition());
+	}
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getActiveCount(); ++currentTank) {
+		markActiveChunksAround(m_enemyTankPool->getActiveTank(currentTank).getCurrentPosition());
+	}
 }
 
 void Level::initLevel() {
 	switch (m_eGameMode)
 	{
 	case Game::EGameMode::TwoPlayers:
-		m_tank2 = std::make_shared<Tank>(Tank::ETankType::Player2Green_type1, false, true, Tank::EOrientation::Top, 0.05, getPlayerRespawn_2(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f);
+		m_tank2 = m_arena.makeShared<Tank>(Tank::ETankType::Player2Green_type1, false, true, Tank::EOrientation::Top, 0.05, getPlayerRespawn_2(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f, m_bulletPool.get(), &m_timerWheel, &m_animationSystem, &m_entityWorld);
 		Physics::PhysicsEngine::addDynamicGameObject(m_tank2);
 		[[fallthrough]];
 	case Game::EGameMode::OnePlayer:
-		m_tank1 = std::make_shared<Tank>(Tank::ETankType::Player1Yellow_type1, false, true, Tank::EOrientation::Top, 0.05, getPlayerRespawn_1(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f);
+		m_tank1 = m_arena.makeShared<Tank>(Tank::ETankType::Player1Yellow_type1, false, true, Tank::EOrientation::Top, 0.05, getPlayerRespawn_1(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f, m_bulletPool.get(), &m_timerWheel, &m_animationSystem, &m_entityWorld);
 		Physics::PhysicsEngine::addDynamicGameObject(m_tank1);
 	}
 
-	m_enemyTanks.emplace(std::make_shared<Tank>(Tank::ETankType::EnemyWhite_type1, true, false, Tank::EOrientation::Bottom, 0.05, getEnemyRespawn_1(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f));
-	m_enemyTanks.emplace(std::make_shared<Tank>(Tank::ETankType::EnemyWhite_type4, true, false, Tank::EOrientation::Bottom, 0.05, getEnemyRespawn_2(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f));
-	m_enemyTanks.emplace(std::make_shared<Tank>(Tank::ETankType::EnemyWhite_type2, true, false, Tank::EOrientation::Bottom, 0.05, getEnemyRespawn_3(), glm::vec2(Level::BLOCK_SIZE, Level::BLOCK_SIZE), 1.f));
+	for (const auto& currentTank : { m_tank1, m_tank2 }) {
+		if (currentTank) {
+			registerTickObject(m_dynamicTickLists, currentTank.get());
+		}
+	}
+
+	const auto addEntityObject = [this](std::shared_ptr<IGameObject> object)
+	{
+		const uint32_t entityIndex = getEntityIndex(object.get());
+		if (entityIndex >= m_entityObjects.size()) {
+			m_entityObjects.resize(entityIndex + 1);
+		}
+		m_entityObjects[entityIndex] = std::move(object);
+	};
+	for (const auto& currentTank : { m_tank1, m_tank2 }) {
+		if (currentTank) {
+			addEntityObject(currentTank);
+		}
+	}
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getCapacity(); ++currentTank) {
+		addEntityObject(m_enemyTankPool->getTankAt(currentTank));
+	}
+	for (size_t currentBullet = 0; currentBullet < m_bulletPool->getCapacity(); ++currentBullet) {
+		addEntityObject(m_bulletPool->getBullet(currentBullet));
+	}
+
+	// one enemy at every respawn point
+	for (size_t currentTank = 0; currentTank < 3; ++currentTank) {
+		spawnEnemyTank();
+	}
+
+	updateActiveChunks();
+}
 
-	for (const auto& currentTank : m_enemyTanks) {
-		Physics::PhysicsEngine::addDynamicGameObject(currentTank);
+bool Level::spawnEnemyTank() {
+	if (m_spawnedEnemyTanks == ENEMY_TANKS_PER_LEVEL) {
+		return false;
 	}
+
+	const glm::ivec2* spawnPoints[] = { &m_enemyRespawn_1, &m_enemyRespawn_2, &m_enemyRespawn_3 };
+	const glm::vec2 spawnPoint(*spawnPoints[m_spawnedEnemyTanks % 3]);
+	Tank* tank = m_enemyTankPool->getTank(m_enemyTankPool->spawn(ENEMY_SPAWN_ORDER[m_spawnedEnemyTanks % ENEMY_SPAWN_ORDER.size()], spawnPoint));
+	if (!tank) {
+		return false;
+	}
+	tank->getAIComponent()->setNavigation(&m_navigationGrid, { &m_eagleFlowField, &m_playerFlowFields[0], &m_playerFlowFields[1] }, &m_threatMap);
+	m_aiScheduler.add(*tank->getAIComponent());
+	++m_spawnedEnemyTanks;
+	return true;
 }
 
-void Level::render() const {
-	for (const auto& currentLevelObject : m_levelObjects) {
-		if (currentLevelObject) {
-			currentLevelObject->render();
+void Level::onEnemySpawnTimer() {
+	if (m_pendingEnemySpawns > 0 && spawnEnemyTank()) {
+		--m_pendingEnemySpawns;
+	}
+	if (m_pendingEnemySpawns > 0 && m_spawnedEnemyTanks < ENEMY_TANKS_PER_LEVEL) {
+		m_enemySpawnTimer = m_timerWheel.schedule(ENEMY_SPAWN_DELAY, TimerWheel::Callback::bind<Level, &Level::onEnemySpawnTimer>(this));
+	}
+}
+
+void Level::markNavigationCells(IGameObject& object) {
+	const bool isDestructible = object.getObjectType() == IGameObject::EObjectType::BrickWall;
+	const bool blocksTanks = object.collides(IGameObject::EObjectType::Tank);
+	// water stops tanks but not bullets
+	const bool blocksBullets = object.collides(IGameObject::EObjectType::Bullet);
+	// bricks can be shot through, everything else has to be driven around
+	const uint16_t cost = isDestructible ? NavigationGrid::BRICK_CELL_COST : NavigationGrid::BLOCKED;
+	const glm::vec2& position = object.getCurrentPosition();
+	for (const auto& collider : object.getColliders()) {
+		if (collider.isActive) {
+			const Physics::AABB area(position + collider.boundingBox.bottomLeft, position + collider.boundingBox.topRight);
+			if (blocksTanks) {
+				m_navigationGrid.setArea(area, cost);
+			}
+			if (blocksBullets) {
+				m_threatMap.setArea(area, true, isDestructible);
+			}
 		}
 	}
-	
-	switch (m_eGameMode)
+}
+
+void Level::buildNavigation() {
+	const size_t cellsPerBlock = BLOCK_SIZE / NavigationGrid::CELL_SIZE;
+	m_navigationGrid.reset(m_widthBlocks * cellsPerBlock, m_heightBlocks * cellsPerBlock, glm::vec2(BLOCK_SIZE, BLOCK_SIZE / 2.f));
+	m_threatMap.reset();
+	m_observationEncoder.reset();
+	m_isWorldTerrainDirty = true;
+	for (const auto& chunk : m_chunks) {
+		if (chunk) {
+			for (const auto& currentObject : chunk->objects) {
+				if (currentObject) {
+					markNavigationCells(*currentObject);
+					m_observationEncoder.addTerrain(*currentObject);
+				}
+			}
+		}
+	}
+	m_navigationGrid.commitChanges(m_changedNavigationNodes);
+
+	if (m_eagleSize.x > 0) {
+		glm::ivec2 eagleMin;
+		glm::ivec2 eagleMax;
+		m_navigationGrid.getCells(Physics::AABB(m_eaglePosition, m_eaglePosition + m_eagleSize), eagleMin, eagleMax);
+		m_eagleFlowField.setGoal(eagleMin, eagleMax);
+	}
+}
+
+void Level::onBrickWallDamage(BrickWall& wall) {
+	m_damagedWalls.push_back(&wall);
+}
+
+void Level::updateTerrainNavigation() {
+	if (!m_damagedWalls.empty()) {
+		for (BrickWall* currentWall : m_damagedWalls) {
+			const glm::vec2& position = currentWall->getCurrentPosition();
+			m_navigationGrid.setArea(Physics::AABB(position, position + currentWall->getSize()), 0);
+			m_threatMap.setArea(Physics::AABB(position, position + currentWall->getSize()), false, false);
+			markNavigationCells(*currentWall);
+			m_observationEncoder.markTerrainChanged(*currentWall);
+		}
+		m_damagedWalls.clear();
+		m_isWorldTerrainDirty = true;
+
+		// bricks only lose parts, so only the nodes around them have to be updated
+		const bool onlyDecreased = m_navigationGrid.commitChanges(m_changedNavigationNodes);
+		for (FlowField* currentField : { &m_eagleFlowField, &m_playerFlowFields[0], &m_playerFlowFields[1] }) {
+			if (onlyDecreased) {
+				currentField->onCostsDecreased(m_changedNavigationNodes);
+			}
+			else {
+				currentField->rebuild();
+			}
+		}
+	}
+}
+
+void Level::updateNavigation() {
+	updateTerrainNavigation();
+
+	const std::array<Tank*, 2> players = { m_tank1.get(), m_tank2.get() };
+	for (size_t currentPlayer = 0; currentPlayer < players.size(); ++currentPlayer) {
+		FlowField& field = m_playerFlowFields[currentPlayer];
+		if (!players[currentPlayer]) {
+			if (field.hasGoal()) {
+				field.clearGoal();
+			}
+			continue;
+		}
+
+		const glm::ivec2 node = m_navigationGrid.getNode(players[currentPlayer]->getCurrentPosition());
+		const glm::ivec2 offset = glm::abs(node - field.getGoalMin());
+		if (!field.hasGoal() || offset.x + offset.y >= PLAYER_FLOW_FIELD_TOLERANCE) {
+			field.setGoal(node, node + glm::ivec2(static_cast<int>(NavigationGrid::TANK_CELLS)));
+		}
+	}
+}
+
+void Level::updateThreatMap() {
+	m_threatMap.clearTick();
+
+	// only the bullets of the players can destroy enemies
+	for (size_t currentBulletIndex = 0; currentBulletIndex < m_bulletPool->getActiveCount(); ++currentBulletIndex) {
+		Bullet& currentBullet = m_bulletPool->getActiveBullet(currentBulletIndex);
+		if (currentBullet.isExploding() || !currentBullet.isShotByPlayer()) {
+			continue;
+		}
+		m_threatMap.addBullet(currentBullet.getCurrentPosition(), currentBullet.getSize(), currentBullet.getCurrentDirection());
+	}
+
+	for (const auto& player : { m_tank1, m_tank2 }) {
+		if (player) {
+			const glm::vec2& position = player->getCurrentPosition();
+			m_threatMap.addTarget(Physics::AABB(position, position + player->getSize()));
+		}
+	}
+	if (m_eagleSize.x > 0) {
+		m_threatMap.addTarget(Physics::AABB(m_eaglePosition, m_eaglePosition + m_eagleSize));
+	}
+}
+
+void Level::captureWorldState() {
+	const size_t widthCells = m_navigationGrid.getWidthCells();
+	const size_t heightCells = m_navigationGrid.getHeightCells();
+	m_isWorldStateValid = widthCells <= WorldState::MAX_CELLS && heightCells <= WorldState::MAX_CELLS;
+	if (!m_isWorldStateValid) {
+		return;
+	}
+
+	if (m_isWorldTerrainDirty) {
+		m_worldState.tankBlockedRows.fill(0);
+		m_worldState.bulletBlockedRows.fill(0);
+		m_worldState.destructibleRows.fill(0);
+		for (size_t currentY = 0; currentY < heightCells; ++currentY) {
+			for (size_t currentX = 0; currentX < widthCells; ++currentX) {
+				const glm::ivec2 cell(currentX, currentY);
+				const uint64_t bit = uint64_t(1) << currentX;
+				if (m_navigationGrid.getCellCost(cell) != 0) {
+					m_worldState.tankBlockedRows[currentY] |= bit;
+				}
+				if (m_threatMap.isSolid(cell)) {
+					m_worldState.bulletBlockedRows[currentY] |= bit;
+				}
+				if (m_threatMap.isDestructible(cell)) {
+					m_worldState.destructibleRows[currentY] |= bit;
+				}
+			}
+		}
+		m_worldState.origin = m_navigationGrid.getNodePosition(glm::ivec2(0, 0));
+		m_worldState.cellSize = static_cast<float>(NavigationGrid::CELL_SIZE);
+		m_worldState.widthCells = static_cast<uint8_t>(widthCells);
+		m_worldState.heightCells = static_cast<uint8_t>(heightCells);
+		m_isWorldTerrainDirty = false;
+	}
+
+	std::array<ECS::Entity, WorldState::MAX_TANKS> capturedTanks{};
+	m_worldState.tanksCount = 0;
+	const auto captureTank = [this, &capturedTanks](Tank& tank)
 	{
-	case Game::EGameMode::TwoPlayers:
-		m_tank2->render();
-		[[fallthrough]];
-	case Game::EGameMode::OnePlayer:
-		m_tank1->render();
+		if (m_worldState.tanksCount == WorldState::MAX_TANKS) {
+			return;
+		}
+		if (tank.hasAI()) {
+			tank.getAIComponent()->setWorldState(&m_worldState, m_worldState.tanksCount);
+		}
+		capturedTanks[m_worldState.tanksCount] = tank.getEntity();
+		WorldState::Tank& state = m_worldState.tanks[m_worldState.tanksCount++];
+		state.position = tank.getCurrentPosition();
+		state.size = tank.getSize();
+		state.direction = tank.getCurrentDirection();
+		state.velocity = static_cast<float>(tank.getCurrentVelocity());
+		state.maxVelocity = static_cast<float>(tank.getMaxVelocity());
+		state.bulletsInFlight = 0;
+		state.maxBullets = static_cast<uint8_t>(tank.getMaxBullets());
+		state.hasAI = tank.hasAI();
+		state.isInvulnerable = tank.isSpawning() || tank.hasShield();
+		state.isDestroyed = tank.isDestroyed();
+	};
+	for (const auto& player : { m_tank1, m_tank2 }) {
+		if (player) {
+			captureTank(*player);
+		}
+	}
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getActiveCount(); ++currentTank) {
+		captureTank(m_enemyTankPool->getActiveTank(currentTank));
+	}
+
+	m_worldState.bulletsCount = 0;
+	for (size_t currentBulletIndex = 0; currentBulletIndex < m_bulletPool->getActiveCount() && m_worldState.bulletsCount < WorldState::MAX_BULLETS; ++currentBulletIndex) {
+		Bullet& currentBullet = m_bulletPool->getActiveBullet(currentBulletIndex);
+		if (currentBullet.isExploding()) {
+			continue;
+		}
+		WorldState::Bullet& state = m_worldState.bullets[m_worldState.bulletsCount++];
+		state.position = currentBullet.getCurrentPosition();
+		state.size = currentBullet.getSize();
+		state.direction = currentBullet.getCurrentDirection();
+		state.velocity = static_cast<float>(BULLET_VELOCITY);
+		state.owner = WorldState::NO_TANK;
+		for (uint8_t currentTank = 0; currentTank < m_worldState.tanksCount; ++currentTank) {
+			if (capturedTanks[currentTank] == currentBullet.getShooter()) {
+				state.owner = currentTank;
+				++m_worldState.tanks[currentTank].bulletsInFlight;
+				break;
+			}
+		}
+	}
+	m_worldState.bulletVelocity = static_cast<float>(BULLET_VELOCITY);
+	m_worldState.time = 0;
+}
+
+void Level::encodeObservation(uint8_t* planes, const bool isBufferCurrent) {
+	m_observationEncoder.beginEncode(planes, isBufferCurrent);
+	for (const auto& player : { m_tank1, m_tank2 }) {
+		if (player && !player->isDestroyed()) {
+			m_observationEncoder.addTank(player->getCurrentPosition(), player->getSize(), player->getCurrentDirection(), true);
+		}
+	}
+	for (size_t currentTankIndex = 0; currentTankIndex < m_enemyTankPool->getActiveCount(); ++currentTankIndex) {
+		Tank& currentTank = m_enemyTankPool->getActiveTank(currentTankIndex);
+		if (!currentTank.isDestroyed()) {
+			m_observationEncoder.addTank(currentTank.getCurrentPosition(), currentTank.getSize(), currentTank.getCurrentDirection(), false);
+		}
+	}
+	for (size_t currentBulletIndex = 0; currentBulletIndex < m_bulletPool->getActiveCount(); ++currentBulletIndex) {
+		Bullet& currentBullet = m_bulletPool->getActiveBullet(currentBulletIndex);
+		if (!currentBullet.isExploding()) {
+			m_observationEncoder.addBullet(currentBullet.getCurrentPosition(), currentBullet.getSize(), currentBullet.getCurrentDirection());
+		}
+	}
+}
+
+void Level::updateSimulationLOD(const double delta) {
+	m_simulationLODStats.fullBodies = 0;
+	m_simulationLODStats.reducedBodies = 0;
+	m_simulationLODStats.skippedUpdates = 0;
+
+	const float radiusSquared = m_simulationLODRadius * m_simulationLODRadius;
+	for (size_t currentTankIndex = 0; currentTankIndex < m_enemyTankPool->getActiveCount(); ++currentTankIndex) {
+		Tank& currentTank = m_enemyTankPool->getActiveTank(currentTankIndex);
+		const glm::vec2& position = currentTank.getCurrentPosition();
+		float minDistanceSquared = radiusSquared + 1.f;
+		for (const auto& player : { m_tank1, m_tank2 }) {
+			if (player) {
+				const glm::vec2 offset = player->getCurrentPosition() - position;
+				minDistanceSquared = std::min(minDistanceSquared, offset.x * offset.x + offset.y * offset.y);
+			}
+		}
+
+		if (minDistanceSquared > radiusSquared) {
+			currentTank.setSimulationLOD(IGameObject::ESimulationLOD::Reduced);
+			++m_simulationLODStats.reducedBodies;
+		}
+		else {
+			currentTank.setSimulationLOD(IGameObject::ESimulationLOD::Full);
+			++m_simulationLODStats.fullBodies;
+		}
+
+		if (currentTank.advanceSimulationClock(delta) <= 0) {
+			++m_simulationLODStats.skippedUpdates;
+		}
 	}
+}
 
-	for (const auto& currentTank : m_enemyTanks) {
-		currentTank->render();
+void Level::render() const {
+	for (const size_t chunkIndex : m_activeChunks) {
+		for (const auto& currentLevelObject : m_chunks[chunkIndex]->objects) {
+			if (currentLevelObject) {
+				currentLevelObject->render();
+			}
+		}
 	}
+
+	for (const auto& currentBorder : m_borders) {
+		currentBorder->render();
+	}
+
+	// players and pooled enemies alike, straight from the component arrays
+	Tank::renderAll(m_entityWorld, m_animationSystem);
+	Bullet::renderAll(m_entityWorld, m_animationSystem);
 }
 
 void Level::update(const double delta) {
-	for (const auto& currentLevelObject : m_levelObjects) {
-		if (currentLevelObject) {
-			currentLevelObject->update(delta);
+	updateActiveChunks();
+	updateSimulationLOD(delta);
+	updateThreatMap();
+	captureWorldState();
+	// decides on a snapshot of the tanks, the intents are applied by the tanks in the PrePhysics phase
+	m_aiScheduler.update(delta);
+
+	const auto updateStartTime = std::chrono::high_resolution_clock::now();
+	const size_t updatedObjects = runTickPhase(m_dynamicTickLists, IGameObject::ETickPhase::PrePhysics, delta)
+								+ m_enemyTankPool->tick(IGameObject::ETickPhase::PrePhysics, delta);
+	if (updatedObjects > 0) {
+		const double updateTime = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - updateStartTime).count();
+		m_averageTankUpdateTime = updateTime / updatedObjects;
+	}
+	m_simulationLODStats.savedTime += m_simulationLODStats.skippedUpdates * m_averageTankUpdateTime;
+
+	for (const size_t chunkIndex : m_activeChunks) {
+		runTickPhase(m_chunks[chunkIndex]->tickLists, IGameObject::ETickPhase::PrePhysics, delta);
+	}
+
+	Physics::PhysicsEngine::update(delta);
+
+	runTickPhase(IGameObject::ETickPhase::PostPhysics, delta);
+	m_timerWheel.update(delta);
+	m_bulletPool->releaseExpired();
+	updateNavigation();
+
+	const size_t destroyedEnemyTanks = m_enemyTankPool->releaseDestroyed();
+	if (destroyedEnemyTanks > 0) {
+		m_destroyedEnemyTanks += destroyedEnemyTanks;
+		m_pendingEnemySpawns += destroyedEnemyTanks;
+		if (!m_timerWheel.isScheduled(m_enemySpawnTimer)) {
+			m_enemySpawnTimer = m_timerWheel.schedule(ENEMY_SPAWN_DELAY, TimerWheel::Callback::bind<Level, &Level::onEnemySpawnTimer>(this));
 		}
 	}
 
+	m_animationSystem.update(delta);
+}
+
+void Level::processInput(std::array<bool, 349>& keys) {
+	const auto getDirection = [&keys](const int up, const int left, const int right, const int down)
+	{
+		if (keys[up]) {
+			return glm::ivec2(0, 1);
+		}
+		if (keys[left]) {
+			return glm::ivec2(-1, 0);
+		}
+		if (keys[right]) {
+			return glm::ivec2(1, 0);
+		}
+		if (keys[down]) {
+			return glm::ivec2(0, -1);
+		}
+		return glm::ivec2(0, 0);
+	};
+
 	switch (m_eGameMode)
 	{
 	case Game::EGameMode::TwoPlayers:
-		m_tank2->update(delta);
+		applyPlayerAction(1, getDirection(GLFW_KEY_UP, GLFW_KEY_LEFT, GLFW_KEY_RIGHT, GLFW_KEY_DOWN), keys[GLFW_KEY_RIGHT_SHIFT]);
 		[[fallthrough]];
 	case Game::EGameMode::OnePlayer:
-		m_tank1->update(delta);
+		applyPlayerAction(0, getDirection(GLFW_KEY_W, GLFW_KEY_A, GLFW_KEY_D, GLFW_KEY_S), keys[GLFW_KEY_SPACE]);
+	}
+}
+
+void Level::applyPlayerAction(const size_t player, const glm::ivec2& direction, const bool fire) {
+	Tank* tank = player == 0 ? m_tank1.get() : m_tank2.get();
+	if (!tank) {
+		return;
+	}
+
+	if (direction.y > 0) {
+		tank->setOrientation(Tank::EOrientation::Top);
+	}
+	else if (direction.x < 0) {
+		tank->setOrientation(Tank::EOrientation::Left);
+	}
+	else if (direction.x > 0) {
+		tank->setOrientation(Tank::EOrientation::Right);
+	}
+	else if (direction.y < 0) {
+		tank->setOrientation(Tank::EOrientation::Bottom);
 	}
+	tank->setVelocity(direction == glm::ivec2(0, 0) ? 0 : tank->getMaxVelocity());
 
-	for (const auto& currentTank : m_enemyTanks) {
-		currentTank->update(delta);
+	if (fire) {
+		tank->fire();
 	}
 }
 
-void Level::processInput(std::array<bool, 349>& keys) {
-	switch (m_eGameMode)
-	{
-	case Game::EGameMode::TwoPlayers:
-		if (keys[GLFW_KEY_UP]) {
-			m_tank2->setOrientation(Tank::EOrientation::Top);
-			m_tank2->setVelocity(m_tank2->getMaxVelocity());
-		}
-		else if (keys[GLFW_KEY_LEFT]) {
-			m_tank2->setOrientation(Tank::EOrientation::Left);
-			m_tank2->setVelocity(m_tank2->getMaxVelocity());
-		}
-		else if (keys[GLFW_KEY_RIGHT]) {
-			m_tank2->setOrientation(Tank::EOrientation::Right);
-			m_tank2->setVelocity(m_tank2->getMaxVelocity());
+bool Level::isCleared() const {
+	return m_destroyedEnemyTanks == ENEMY_TANKS_PER_LEVEL;
+}
+
+void Level::saveSnapshot(std::vector<uint8_t>& snapshot) const {
+	snapshot.clear();
+	SnapshotWriter writer(snapshot);
+
+	SnapshotHeader header{};
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.widthBlocks = static_cast<uint32_t>(m_widthBlocks);
+	header.heightBlocks = static_cast<uint32_t>(m_heightBlocks);
+	header.brickWallsCount = static_cast<uint32_t>(m_brickWalls.size());
+	header.entitiesCount = static_cast<uint32_t>(m_entityObjects.size());
+	header.eGameMode = m_eGameMode;
+	writer.write(header);
+
+	writer.write(static_cast<uint64_t>(m_spawnedEnemyTanks));
+	writer.write(static_cast<uint64_t>(m_destroyedEnemyTanks));
+	writer.write(static_cast<uint64_t>(m_pendingEnemySpawns));
+	writer.write(m_enemySpawnTimer);
+	// the fields themselves are rebuilt from their goals
+	for (const FlowField& currentField : m_playerFlowFields) {
+		writer.write(static_cast<uint8_t>(currentField.hasGoal()));
+		writer.write(currentField.getGoalMin());
+		writer.write(currentField.getGoalMax());
+	}
+	for (const BrickWall* currentWall : m_brickWalls) {
+		writer.write(currentWall->getBrickStates());
+	}
+
+	m_timerWheel.saveState(writer);
+	m_animationSystem.saveState(writer);
+	m_entityWorld.saveState(writer);
+	m_enemyTankPool->saveState(writer);
+	m_bulletPool->saveState(writer);
+	// the collisions are resolved in this order, so it is part of the state
+	const auto& dynamicObjects = Physics::PhysicsEngine::getDynamicObjects();
+	writer.write(static_cast<uint64_t>(dynamicObjects.size()));
+	for (const auto& currentObject : dynamicObjects) {
+		writer.write(getEntityIndex(currentObject.get()));
+	}
+	m_aiScheduler.saveState(writer);
+	for (const auto& currentTank : { m_tank1, m_tank2 }) {
+		if (currentTank) {
+			currentTank->saveState(writer);
 		}
-		else if (keys[GLFW_KEY_DOWN]) {
-			m_tank2->setOrientation(Tank::EOrientation::Bottom);
-			m_tank2->setVelocity(m_tank2->getMaxVelocity());
+	}
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getCapacity(); ++currentTank) {
+		m_enemyTankPool->getTankAt(currentTank)->saveState(writer);
+	}
+
+	header.size = snapshot.size();
+	header.checksum = getSnapshotChecksum(snapshot.data() + sizeof(SnapshotHeader), snapshot.size() - sizeof(SnapshotHeader));
+	writer.writeAt(0, header);
+}
+
+bool Level::restoreSnapshot(const uint8_t* snapshot, const size_t size) {
+	SnapshotReader reader(snapshot, size);
+	SnapshotHeader header;
+	if (!reader.read(header) || header.magic != SNAPSHOT_MAGIC || header.version != SNAPSHOT_VERSION || header.size != size
+		|| header.checksum != getSnapshotChecksum(snapshot + sizeof(SnapshotHeader), size - sizeof(SnapshotHeader))) {
+		std::cerr << "Invalid level snapshot" << std::endl;
+		return false;
+	}
+	if (m_entityObjects.empty()
+		|| header.widthBlocks != m_widthBlocks || header.heightBlocks != m_heightBlocks || header.eGameMode != m_eGameMode
+		|| header.brickWallsCount != m_brickWalls.size() || header.entitiesCount != m_entityObjects.size()) {
+		std::cerr << "Level snapshot was saved on another level" << std::endl;
+		return false;
+	}
+
+	SnapshotState state;
+	if (!readSnapshot(reader, state) || !reader.isAtEnd()) {
+		std::cerr << "Level snapshot is damaged" << std::endl;
+		return false;
+	}
+	applySnapshot(state);
+	return true;
+}
+
+bool Level::readSnapshot(SnapshotReader& reader, SnapshotState& state) const {
+	reader.read(state.spawnedEnemyTanks);
+	reader.read(state.destroyedEnemyTanks);
+	reader.read(state.pendingEnemySpawns);
+	reader.read(state.enemySpawnTimer);
+	for (size_t currentPlayer = 0; currentPlayer < m_playerFlowFields.size(); ++currentPlayer) {
+		reader.read(state.hasPlayerGoal[currentPlayer]);
+		reader.read(state.playerGoalMin[currentPlayer]);
+		reader.read(state.playerGoalMax[currentPlayer]);
+	}
+	// nothing is read after a failed read, so the reader tells whether all of them succeeded
+	if (!reader.isValid() || state.spawnedEnemyTanks > ENEMY_TANKS_PER_LEVEL
+		|| state.destroyedEnemyTanks > state.spawnedEnemyTanks || state.pendingEnemySpawns > ENEMY_TANKS_PER_LEVEL) {
+		return false;
+	}
+	state.brickStates.resize(m_brickWalls.size());
+	for (auto& currentBrickStates : state.brickStates) {
+		if (!reader.read(currentBrickStates) || !std::all_of(currentBrickStates.begin(), currentBrickStates.end(), BrickWall::isValidBrickState)) {
+			return false;
 		}
-		else {
-			m_tank2->setVelocity(0);
+	}
+
+	if (!m_timerWheel.readState(reader, state.timerWheel) || !m_animationSystem.readState(reader, state.animationSystem)
+		|| !m_entityWorld.readState(reader, state.entityWorld, state.animationSystem)
+		|| !m_enemyTankPool->readState(reader, state.enemyTankPool) || !m_bulletPool->readState(reader, state.bulletPool)) {
+		return false;
+	}
+
+	// every object is in the physics world at most once
+	uint64_t dynamicObjectsCount = 0;
+	if (!reader.read(dynamicObjectsCount) || dynamicObjectsCount > m_entityObjects.size()) {
+		return false;
+	}
+	state.dynamicObjects.resize(static_cast<size_t>(dynamicObjectsCount));
+	std::vector<bool> isDynamicObject(m_entityObjects.size(), false);
+	for (uint32_t& entityIndex : state.dynamicObjects) {
+		if (!reader.read(entityIndex) || entityIndex >= m_entityObjects.size() || !m_entityObjects[entityIndex] || isDynamicObject[entityIndex]) {
+			return false;
 		}
+		isDynamicObject[entityIndex] = true;
+	}
 
-		if (m_tank2 && keys[GLFW_KEY_RIGHT_SHIFT]) {
-			m_tank2->fire();
+	if (!m_aiScheduler.readState(reader, state.aiScheduler)) {
+		return false;
+	}
+	state.tanks.clear();
+	for (const auto& currentTank : { m_tank1, m_tank2 }) {
+		if (currentTank) {
+			state.tanks.emplace_back();
+			if (!currentTank->readState(reader, state.tanks.back())) {
+				return false;
+			}
 		}
-		[[fallthrough]];
-	case Game::EGameMode::OnePlayer:
-		if (keys[GLFW_KEY_W]) {
-			m_tank1->setOrientation(Tank::EOrientation::Top);
-			m_tank1->setVelocity(m_tank1->getMaxVelocity());
+	}
+	const size_t playerTanksCount = state.tanks.size();
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getCapacity(); ++currentTank) {
+		state.tanks.emplace_back();
+		if (!m_enemyTankPool->getTankAt(currentTank)->readState(reader, state.tanks.back())) {
+			return false;
 		}
-		else if (keys[GLFW_KEY_A]) {
-			m_tank1->setOrientation(Tank::EOrientation::Left);
-			m_tank1->setVelocity(m_tank1->getMaxVelocity());
+	}
+
+	// every entry of the scheduler belongs to exactly one tank on the level, enemies waiting in the pool have none
+	std::vector<bool> isEnemyActive(m_enemyTankPool->getCapacity(), false);
+	for (const size_t tankIndex : state.enemyTankPool.activeTanks.values) {
+		isEnemyActive[tankIndex] = true;
+	}
+	std::vector<bool> isEntryClaimed(state.aiScheduler.decisionTimes.size(), false);
+	for (size_t currentTank = 0; currentTank < state.tanks.size(); ++currentTank) {
+		const uint64_t schedulerIndex = state.tanks[currentTank].ai.schedulerIndex;
+		if (schedulerIndex == AIScheduler::INVALID_INDEX) {
+			continue;
 		}
-		else if (keys[GLFW_KEY_D]) {
-			m_tank1->setOrientation(Tank::EOrientation::Right);
-			m_tank1->setVelocity(m_tank1->getMaxVelocity());
+		const bool isOnLevel = currentTank < playerTanksCount || isEnemyActive[currentTank - playerTanksCount];
+		if (!isOnLevel || schedulerIndex >= isEntryClaimed.size() || isEntryClaimed[schedulerIndex]) {
+			return false;
 		}
-		else if (keys[GLFW_KEY_S]) {
-			m_tank1->setOrientation(Tank::EOrientation::Bottom);
-			m_tank1->setVelocity(m_tank1->getMaxVelocity());
+		isEntryClaimed[schedulerIndex] = true;
+	}
+	return std::find(isEntryClaimed.begin(), isEntryClaimed.end(), false) == isEntryClaimed.end();
+}
+
+void Level::applySnapshot(const SnapshotState& state) {
+	m_spawnedEnemyTanks = static_cast<size_t>(state.spawnedEnemyTanks);
+	m_destroyedEnemyTanks = static_cast<size_t>(state.destroyedEnemyTanks);
+	m_pendingEnemySpawns = static_cast<size_t>(state.pendingEnemySpawns);
+	m_enemySpawnTimer = state.enemySpawnTimer;
+	for (size_t currentWall = 0; currentWall < m_brickWalls.size(); ++currentWall) {
+		BrickWall* wall = m_brickWalls[currentWall];
+		if (state.brickStates[currentWall] != wall->getBrickStates()) {
+			wall->setBrickStates(state.brickStates[currentWall]);
+			m_damagedWalls.push_back(wall);
 		}
-		else {
-			m_tank1->setVelocity(0);
+	}
+
+	m_timerWheel.restoreState(state.timerWheel);
+	m_animationSystem.restoreState(state.animationSystem);
+	m_entityWorld.restoreState(state.entityWorld);
+	m_enemyTankPool->restoreState(state.enemyTankPool);
+	m_bulletPool->restoreState(state.bulletPool);
+	m_timerWheel.setCallback(m_enemySpawnTimer, TimerWheel::Callback::bind<Level, &Level::onEnemySpawnTimer>(this));
+
+	Physics::PhysicsEngine::clearDynamicObjects();
+	for (const uint32_t entityIndex : state.dynamicObjects) {
+		Physics::PhysicsEngine::addDynamicGameObject(m_entityObjects[entityIndex]);
+	}
+
+	m_aiScheduler.restoreState(state.aiScheduler);
+	auto savedTank = state.tanks.begin();
+	for (const auto& currentTank : { m_tank1, m_tank2 }) {
+		if (currentTank) {
+			currentTank->restoreState(*savedTank++, m_aiScheduler);
 		}
+	}
+	for (size_t currentTank = 0; currentTank < m_enemyTankPool->getCapacity(); ++currentTank) {
+		Tank& tank = *m_enemyTankPool->getTankAt(currentTank);
+		tank.getAIComponent()->setNavigation(&m_navigationGrid, { &m_eagleFlowField, &m_playerFlowFields[0], &m_playerFlowFields[1] }, &m_threatMap);
+		tank.restoreState(*savedTank++, m_aiScheduler);
+	}
 
-		if (m_tank1 && keys[GLFW_KEY_SPACE]) {
-			m_tank1->fire();
+	// the navigation follows the bricks that changed; player fields whose goal moved are cleared
+	// before and built after it, so they are built once and only for the restored goal
+	std::array<bool, 2> isPlayerGoalMoved{};
+	for (size_t currentPlayer = 0; currentPlayer < m_playerFlowFields.size(); ++currentPlayer) {
+		FlowField& field = m_playerFlowFields[currentPlayer];
+		isPlayerGoalMoved[currentPlayer] = state.hasPlayerGoal[currentPlayer] != field.hasGoal()
+			|| field.getGoalMin() != state.playerGoalMin[currentPlayer] || field.getGoalMax() != state.playerGoalMax[currentPlayer];
+		if (isPlayerGoalMoved[currentPlayer] && field.hasGoal()) {
+			field.clearGoal();
 		}
 	}
+	updateTerrainNavigation();
+	for (size_t currentPlayer = 0; currentPlayer < m_playerFlowFields.size(); ++currentPlayer) {
+		if (isPlayerGoalMoved[currentPlayer] && state.hasPlayerGoal[currentPlayer]) {
+			m_playerFlowFields[currentPlayer].setGoal(state.playerGoalMin[currentPlayer], state.playerGoalMax[currentPlayer]);
+		}
+	}
+	m_isWorldStateValid = false;
+	updateActiveChunks();
 }
 
 unsigned int Level::getStateWidth() const {
@@ -278,9 +1029,8 @@ unsigned int Level::getStateHeight() const {
 	return static_cast<unsigned int>((m_heightBlocks + 1) * BLOCK_SIZE);
 }
 
-std::vector<std::shared_ptr<IGameObject>> Level::getObjectsInArea(const glm::vec2& bottomLeft, const glm::vec2& topRight) const {
-	std::vector<std::shared_ptr<IGameObject>> output;
-	output.reserve(9);
+void Level::getObjectsInArea(const glm::vec2& bottomLeft, const glm::vec2& topRight, std::vector<IGameObject*>& output) const {
+	output.clear();
 
 	glm::vec2 bottomLeft_converted (std::clamp(bottomLeft.x - BLOCK_SIZE, 0.f, static_cast<float>(m_widthPixels)),
 									std::clamp(m_heightPixels - bottomLeft.y + BLOCK_SIZE / 2, 0.f, static_cast<float>(m_heightPixels)));
@@ -295,25 +1045,23 @@ std::vector<std::shared_ptr<IGameObject>> Level::getObjectsInArea(const glm::vec
 
 	for (size_t currentColumn = startX; currentColumn < endX; ++currentColumn) {
 		for (size_t currentRow = startY; currentRow < endY; ++currentRow) {
-			auto& currentObject = m_levelObjects[currentRow * m_widthBlocks + currentColumn];
+			const auto& currentObject = getObjectAt(currentColumn, currentRow);
 			if (currentObject) {
-				output.push_back(currentObject);
+				output.push_back(currentObject.get());
 			}
 		}
 	}
 
 	if (endX >= m_widthBlocks) {
-		output.push_back(m_levelObjects[m_levelObjects.size() - 1]);
+		output.push_back(m_borders[static_cast<size_t>(EBorder::Right)].get());
 	}
 	if (startX <= 1) {
-		output.push_back(m_levelObjects[m_levelObjects.size() - 2]);
+		output.push_back(m_borders[static_cast<size_t>(EBorder::Left)].get());
 	}
 	if (startY <= 1) {
-		output.push_back(m_levelObjects[m_levelObjects.size() - 3]);
+		output.push_back(m_borders[static_cast<size_t>(EBorder::Top)].get());
 	}
 	if (endY >= m_heightBlocks) {
-		output.push_back(m_levelObjects[m_levelObjects.size() - 4]);
+		output.push_back(m_borders[static_cast<size_t>(EBorder::Bottom)].get());
 	}
-
-	return output;
 }
\ No newline at end of file
@@ -3,26 +3,71 @@
 #include <vector>
 #include <string>
 #include <memory>
-#include <set>
+#include <array>
 #include <glm/vec2.hpp>
 
 #include "IGameState.h"
 #include "../Game.h"
+#include "../GameObjects/IGameObject.h"
+#include "../../System/TimerWheel.h"
+#include "../../System/MonotonicArena.h"
+#include "../../Renderer/AnimationSystem.h"
+#include "../ECS/DynamicEntityWorld.h"
+#include "../FlowField.h"
+#include "../ThreatMap.h"
+#include "../ObservationEncoder.h"
+#include "../WorldState.h"
+#include "../AIScheduler.h"
 
-class IGameObject;
 class Tank;
+class BrickWall;
+class BulletPool;
+class EnemyTankPool;
+class SnapshotReader;
 
 class Level : public IGameState {
 public:
 	static constexpr unsigned int BLOCK_SIZE = 16;
+	// level is split into square chunks of CHUNK_SIZE x CHUNK_SIZE blocks
+	static constexpr size_t CHUNK_SIZE = 16;
+	// chunks closer than this (in chunks) to a tank are updated and rendered
+	static constexpr size_t ACTIVE_CHUNK_RADIUS = 1;
+	// bullets preallocated for the whole level
+	static constexpr size_t BULLET_POOL_CAPACITY = 256;
+	static constexpr double BULLET_VELOCITY = 0.1;
+	// enemy tanks on the level at the same time, all of them are constructed when the level loads
+	static constexpr size_t MAX_ENEMY_TANKS = 4;
+	static constexpr size_t ENEMY_TANKS_PER_LEVEL = 20;
+	// delay between the destruction of an enemy and the spawn of the next one (ms)
+	static constexpr double ENEMY_SPAWN_DELAY = 3000;
+	// player flow fields are rebuilt once the player is this far (in nodes) from the goal they were built for
+	static constexpr int PLAYER_FLOW_FIELD_TOLERANCE = 4;
+	// terrain, chunks, tanks and bullets of a level are allocated from blocks of this size (bytes)
+	static constexpr size_t ARENA_BLOCK_SIZE = 256 * 1024;
+	// every enemy tank picks its target once per interval (ms)
+	static constexpr double AI_REPLAN_INTERVAL = 250;
+	// time the AI may spend on decisions per tick (ms), the rest waits for the next tick
+	static constexpr double AI_BUDGET = 0.5;
+
+	struct SimulationLODStats {
+		size_t fullBodies = 0;
+		size_t reducedBodies = 0;
+		// tank updates skipped during the last tick
+		size_t skippedUpdates = 0;
+		// estimated time saved by skipped updates since the level start (ms)
+		double savedTime = 0;
+	};
 
 	Level(const std::vector<std::string>& levelDescription, const Game::EGameMode eGameMode);
+	~Level();
 
 	virtual void render() const override;
 	virtual void update(const double delta) override;
 	virtual unsigned int getStateWidth() const override;
 	virtual unsigned int getStateHeight() const override;
 	virtual void processInput(std::array<bool, 349>& keys) override;
+	// moves the player along the direction, (0, 0) stops it; what the keys of the player do
+	void applyPlayerAction(const size_t player, const glm::ivec2& direction, const bool fire);
 
 	const glm::ivec2& getPlayerRespawn_1() const { return m_playerRespawn_1; }
 	const glm::ivec2& getPlayerRespawn_2() const { return m_playerRespawn_2; }
@@ -30,12 +75,110 @@ public:
 	const glm::ivec2& getEnemyRespawn_2() const { return m_enemyRespawn_2; }
 	const glm::ivec2& getEnemyRespawn_3() const { return m_enemyRespawn_3; }
 
-	std::vector<std::shared_ptr<IGameObject>> getObjectsInArea(const glm::vec2& bottomLeft, const glm::vec2& topRight) const;
+	// replaces the contents of output with the terrain and borders in the area
+	void getObjectsInArea(const glm::vec2& bottomLeft, const glm::vec2& topRight, std::vector<IGameObject*>& output) const;
 	void initLevel();
+	// the level may be built before the mode is known, it has to be set before initLevel
+	void setGameMode(const Game::EGameMode eGameMode) { m_eGameMode = eGameMode; }
+	Game::EGameMode getGameMode() const { return m_eGameMode; }
+
+	size_t getActiveChunksCount() const { return m_activeChunks.size(); }
+	size_t getWidthChunks() const { return m_widthChunks; }
+	size_t getHeightChunks() const { return m_heightChunks; }
+	// chunk the position is in, positions outside the level are clamped to its edge chunks
+	size_t getChunkIndexAt(const glm::vec2& position) const;
+	size_t getAllocatedChunksCount() const;
+
+	void setSimulationLODRadius(const float radius) { m_simulationLODRadius = radius; }
+	float getSimulationLODRadius() const { return m_simulationLODRadius; }
+	const SimulationLODStats& getSimulationLODStats() const { return m_simulationLODStats; }
+
+	void setAIBudget(const double budget) { m_aiScheduler.setBudget(budget); }
+	// nullptr makes the decisions on the thread updating the level
+	void setAIThreadPool(ThreadPool* threadPool) { m_aiScheduler.setThreadPool(threadPool); }
+	const AIScheduler::Metrics& getAISchedulerMetrics() const { return m_aiScheduler.getMetrics(); }
+	// copy of the level as of the last capture, nullptr if the level is larger than it can hold;
+	// the level captures it at the start of every tick
+	void captureWorldState();
+	const WorldState* getWorldState() const { return m_isWorldStateValid ? &m_worldState : nullptr; }
+	// planes of the observation encoder, isBufferCurrent means the buffer holds the last encoding of this level
+	void encodeObservation(uint8_t* planes, const bool isBufferCurrent);
+	const ObservationEncoder& getObservationEncoder() const { return m_observationEncoder; }
+	size_t getDestroyedEnemyTanks() const { return m_destroyedEnemyTanks; }
+	bool isCleared() const;
+	// The state of the match as one flat blob: bricks, tanks, bullets, timers, animations and physics bodies.
+	// Objects are referred to by their entity and pool indices, so the blob can be restored into any level
+	// built from the same description in the same mode, while that level is in the current physics world.
+	// Navigation and everything else rebuilt every tick is derived again after a restore.
+	// A snapshot is checked completely before any of it is applied, a rejected one leaves the level as it was.
+	void saveSnapshot(std::vector<uint8_t>& snapshot) const;
+	bool restoreSnapshot(const uint8_t* snapshot, const size_t size);
 
 private:
+	// objects registered for every update phase; the owner of the list keeps them alive
+	typedef std::array<std::vector<IGameObject*>, static_cast<size_t>(IGameObject::ETickPhase::Count)> TickLists;
+
+	struct LevelChunk {
+		std::array<std::shared_ptr<IGameObject>, CHUNK_SIZE * CHUNK_SIZE> objects;
+		TickLists tickLists;
+	};
+
+	struct SnapshotHeader {
+		uint32_t magic;
+		uint32_t version;
+		// of the whole snapshot (bytes)
+		uint64_t size;
+		// of everything after the header
+		uint64_t checksum;
+		uint32_t widthBlocks;
+		uint32_t heightBlocks;
+		uint32_t brickWallsCount;
+		uint32_t entitiesCount;
+		Game::EGameMode eGameMode;
+	};
+	// everything read from a snapshot, held until all of it is checked
+	struct SnapshotState;
+
+	enum class EBorder : uint8_t {
+		Bottom,
+		Top,
+		Left,
+		Right
+	};
+
+	const std::shared_ptr<IGameObject>& getObjectAt(const size_t column, const size_t row) const;
+	void setObjectAt(const size_t column, const size_t row, std::shared_ptr<IGameObject> object);
+	void markActiveChunksAround(const glm::vec2& position);
+	void updateActiveChunks();
+	void updateSimulationLOD(const double delta);
+	static void registerTickObject(TickLists& tickLists, IGameObject* object);
+	static size_t runTickPhase(const TickLists& tickLists, const IGameObject::ETickPhase eTickPhase, const double delta);
+	void runTickPhase(const IGameObject::ETickPhase eTickPhase, const double delta);
+	bool spawnEnemyTank();
+	void onEnemySpawnTimer();
+	void markNavigationCells(IGameObject& object);
+	void buildNavigation();
+	// applies the damaged walls to the navigation and the flow fields
+	void updateTerrainNavigation();
+	void updateNavigation();
+	void updateThreatMap();
+	void onBrickWallDamage(BrickWall& wall);
+	bool readSnapshot(SnapshotReader& reader, SnapshotState& state) const;
+	void applySnapshot(const SnapshotState& state);
+
+	// declared first so it is destroyed last, after every object placed into it
+	MonotonicArena m_arena;
+
+	// declared before the terrain and the tanks so they outlive every timer and animation the objects hold
+	TimerWheel m_timerWheel;
+	AIScheduler m_aiScheduler;
+	RenderEngine::AnimationSystem m_animationSystem;
+	RenderEngine::AnimationSystem::Handle m_waterAnimation;
+
 	size_t m_widthBlocks = 0;
 	size_t m_heightBlocks = 0;
+	size_t m_widthChunks = 0;
+	size_t m_heightChunks = 0;
 	unsigned int m_widthPixels = 0;
 	unsigned int m_heightPixels = 0;
 
@@ -45,9 +188,46 @@ private:
 	glm::ivec2 m_enemyRespawn_2;
 	glm::ivec2 m_enemyRespawn_3;
 
-	std::vector<std::shared_ptr<IGameObject>> m_levelObjects;
+	// chunks are allocated on the first non-empty block placed into them
+	std::vector<MonotonicArena::UniquePtr<LevelChunk>> m_chunks;
+	std::vector<bool> m_isChunkActive;
+	std::vector<size_t> m_activeChunks;
+	std::array<std::shared_ptr<IGameObject>, 4> m_borders;
+	// tick lists of the player tanks, terrain is registered in its chunk
+	TickLists m_dynamicTickLists;
+	// components of the tanks and bullets, the tank and bullet objects are handles into it
+	DynamicEntityWorld m_entityWorld;
+	MonotonicArena::UniquePtr<BulletPool> m_bulletPool;
 	std::shared_ptr<Tank> m_tank1;
 	std::shared_ptr<Tank> m_tank2;
-	std::set<std::shared_ptr<Tank>> m_enemyTanks;
+	MonotonicArena::UniquePtr<EnemyTankPool> m_enemyTankPool;
+	// flow fields toward the eagle and every player, shared by all enemy tanks
+	NavigationGrid m_navigationGrid;
+	FlowField m_eagleFlowField;
+	std::array<FlowField, 2> m_playerFlowFields;
+	// line of sight and the paths of the player bullets, rebuilt every tick before the AI decides
+	ThreatMap m_threatMap;
+	ObservationEncoder m_observationEncoder;
+	// cloned by the AI for its rollouts, the terrain is only copied again after it changes
+	WorldState m_worldState{};
+	bool m_isWorldStateValid = false;
+	bool m_isWorldTerrainDirty = true;
+	std::vector<BrickWall*> m_damagedWalls;
+	// in the order of the description, how snapshots refer to the bricks
+	std::vector<BrickWall*> m_brickWalls;
+	// tanks and bullets by their entity index, how snapshots refer to them
+	std::vector<std::shared_ptr<IGameObject>> m_entityObjects;
+	std::vector<uint32_t> m_changedNavigationNodes;
+	glm::vec2 m_eaglePosition = glm::vec2(0);
+	glm::vec2 m_eagleSize = glm::vec2(0);
+	size_t m_spawnedEnemyTanks = 0;
+	size_t m_destroyedEnemyTanks = 0;
+	size_t m_pendingEnemySpawns = 0;
+	TimerWheel::Handle m_enemySpawnTimer;
 	Game::EGameMode m_eGameMode;
+
+	// enemy tanks further than this from every player are simulated at reduced LOD
+	float m_simulationLODRadius = 12.f * BLOCK_SIZE;
+	SimulationLODStats m_simulationLODStats;
+	double m_averageTankUpdateTime = 0;
 };
\ No newline at end of file
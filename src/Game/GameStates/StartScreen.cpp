@@ -72,7 +72,7 @@ StartScreen::StartScreen(const std::vector<std::string>& startScreenDescription,
 	, m_keyReleased(true)
 	, m_menuSprite(std::make_pair(ResourceManager::getSprite("menu"), glm::vec2(11 * BLOCK_SIZE, STARTSCREEN_HEIGHT - startScreenDescription.size() * BLOCK_SIZE - MENU_HEIGHT - 5 * BLOCK_SIZE)))
 	, m_tankSprite(std::make_pair(ResourceManager::getSprite("player1_yellow_tank_type1_sprite_right"), glm::vec2(8 * BLOCK_SIZE, m_menuSprite.second.y + 6 * BLOCK_SIZE - m_currentMenuSelection * 2 * BLOCK_SIZE)))
-	, m_tankSpriteAnimator(m_tankSprite.first)
+	, m_tankAnimation(m_animationSystem.create(m_tankSprite.first))
 {
 	if (startScreenDescription.empty()) {
 		std::cerr << "Empty start screen description!" << std::endl;
@@ -107,11 +107,11 @@ void StartScreen::render() const {
 		}
 	}
 	m_menuSprite.first->render(m_menuSprite.second, glm::vec2(MENU_WIDTH, MENU_HEIGHT), 0.f);
-	m_tankSprite.first->render(glm::vec2(m_tankSprite.second.x, m_tankSprite.second.y - m_currentMenuSelection * 2 * BLOCK_SIZE), glm::vec2(TANK_SIZE), 0.f, 0.f, m_tankSpriteAnimator.getCurrentFrame());
+	m_tankSprite.first->render(glm::vec2(m_tankSprite.second.x, m_tankSprite.second.y - m_currentMenuSelection * 2 * BLOCK_SIZE), glm::vec2(TANK_SIZE), 0.f, 0.f, m_animationSystem.getCurrentFrame(m_tankAnimation));
 }
 
 void StartScreen::update(const double delta) {
-	m_tankSpriteAnimator.update(delta);
+	m_animationSystem.update(delta);
 }
 
 void StartScreen::processInput(std::array<bool, 349>& keys) {
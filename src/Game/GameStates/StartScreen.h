@@ -6,7 +6,7 @@
 #include <glm/vec2.hpp>
 
 #include "IGameState.h"
-#include "../../Renderer/SpriteAnimator.h"
+#include "../../Renderer/AnimationSystem.h"
 
 namespace RenderEngine {
 	class Sprite;
@@ -39,5 +39,6 @@ private:
 	std::vector<std::pair<std::shared_ptr<RenderEngine::Sprite>, glm::vec2>> m_sprites;
 	std::pair<std::shared_ptr<RenderEngine::Sprite>, glm::vec2> m_menuSprite;
 	std::pair<std::shared_ptr<RenderEngine::Sprite>, glm::vec2> m_tankSprite;
-	RenderEngine::SpriteAnimator m_tankSpriteAnimator;
+	RenderEngine::AnimationSystem m_animationSystem;
+	RenderEngine::AnimationSystem::Handle m_tankAnimation;
 };
\ No newline at end of file
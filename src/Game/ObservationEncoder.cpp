@@ -0,0 +1,177 @@
+#include "ObservationEncoder.h"
+
+#include <cstring>
+
+#include "FlowField.h"
+#include "ThreatMap.h"
+#include "GameObjects/BrickWall.h"
+
+ObservationEncoder::ObservationEncoder(const NavigationGrid* grid, const size_t maxDynamicObjects)
+	: m_grid(grid)
+	, m_planes(nullptr)
+	, m_isTerrainChanged(true)
+{
+	m_drawnAreas.reserve(maxDynamicObjects);
+}
+
+void ObservationEncoder::reset() {
+	m_terrain.clear();
+	m_changedTerrain.clear();
+	m_isTerrainChanged = true;
+	m_drawnAreas.clear();
+}
+
+void ObservationEncoder::addTerrain(IGameObject& object) {
+	m_terrain.push_back(&object);
+	m_isTerrainChanged = true;
+}
+
+void ObservationEncoder::markTerrainChanged(IGameObject& object) {
+	if (m_isTerrainChanged) {
+		return;
+	}
+	if (m_changedTerrain.size() == m_changedTerrain.capacity()) {
+		m_changedTerrain.clear();
+		m_isTerrainChanged = true;
+		return;
+	}
+	m_changedTerrain.push_back(&object);
+}
+
+size_t ObservationEncoder::getWidthCells() const {
+	return m_grid->getWidthCells();
+}
+
+size_t ObservationEncoder::getHeightCells() const {
+	return m_grid->getHeightCells();
+}
+
+void ObservationEncoder::beginEncode(uint8_t* planes, const bool isBufferCurrent) {
+	m_planes = planes;
+	const size_t planeSize = getWidthCells() * getHeightCells();
+
+	if (!isBufferCurrent) {
+		std::memset(m_planes, 0, getSize());
+		m_drawnAreas.clear();
+		m_isTerrainChanged = true;
+	}
+	else {
+		for (const DrawnArea& currentArea : m_drawnAreas) {
+			fillCells(currentArea.ePlane, currentArea.min, currentArea.max, 0);
+		}
+		m_drawnAreas.clear();
+	}
+
+	if (m_isTerrainChanged) {
+		std::memset(m_planes, 0, TERRAIN_PLANES_COUNT * planeSize);
+		for (IGameObject* currentObject : m_terrain) {
+			drawTerrain(*currentObject);
+		}
+		m_isTerrainChanged = false;
+		// from now on at most every object once between encodings fits without allocating
+		m_changedTerrain.reserve(m_terrain.size());
+	}
+	else {
+		for (IGameObject* currentObject : m_changedTerrain) {
+			const glm::vec2& position = currentObject->getCurrentPosition();
+			const Physics::AABB area(position, position + currentObject->getSize());
+			for (size_t currentPlane = 0; currentPlane < TERRAIN_PLANES_COUNT; ++currentPlane) {
+				fillArea(static_cast<EPlane>(currentPlane), area, 0);
+			}
+			drawTerrain(*currentObject);
+		}
+	}
+	m_changedTerrain.clear();
+}
+
+void ObservationEncoder::addTank(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction, const bool isPlayer) {
+	const EPlane eFirstPlane = isPlayer ? EPlane::PlayerTop : EPlane::EnemyTop;
+	const size_t orientation = static_cast<size_t>(ThreatMap::getDirection(glm::ivec2(direction)));
+	drawDynamicObject(static_cast<EPlane>(static_cast<size_t>(eFirstPlane) + orientation), Physics::AABB(position, position + size));
+}
+
+void ObservationEncoder::addBullet(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction) {
+	const size_t orientation = static_cast<size_t>(ThreatMap::getDirection(glm::ivec2(direction)));
+	drawDynamicObject(static_cast<EPlane>(static_cast<size_t>(EPlane::BulletTop) + orientation), Physics::AABB(position, position + size));
+}
+
+void ObservationEncoder::drawDynamicObject(const EPlane ePlane, const Physics::AABB& area) {
+	if (m_drawnAreas.size() == m_drawnAreas.capacity()) {
+		return;
+	}
+	DrawnArea drawnArea;
+	drawnArea.ePlane = ePlane;
+	m_grid->getCells(area, drawnArea.min, drawnArea.max);
+	fillCells(ePlane, drawnArea.min, drawnArea.max, 1);
+	m_drawnAreas.push_back(drawnArea);
+}
+
+void ObservationEncoder::drawTerrain(IGameObject& object) {
+	const glm::vec2& position = object.getCurrentPosition();
+	switch (object.getObjectType())
+	{
+	case IGameObject::EObjectType::BrickWall:
+	{
+		// every brick is split into quarters of a cell each
+		const BrickWall& wall = static_cast<const BrickWall&>(object);
+		const glm::vec2 quarterSize = object.getSize() / 4.f;
+		for (size_t currentLocation = 0; currentLocation < 4; ++currentLocation) {
+			const BrickWall::EBrickLocation eLocation = static_cast<BrickWall::EBrickLocation>(currentLocation);
+			const uint8_t quarters = wall.getBrickQuarters(eLocation);
+			const glm::vec2 brickPosition = position + wall.getBrickOffset(eLocation);
+			for (uint8_t currentQuarter = 0; currentQuarter < 4; ++currentQuarter) {
+				if (quarters & (1 << currentQuarter)) {
+					// the first two quarters are the top row
+					const glm::vec2 offset = glm::vec2(currentQuarter & 1, currentQuarter < 2 ? 1 : 0) * quarterSize;
+					fillArea(EPlane::BrickWall, Physics::AABB(brickPosition + offset, brickPosition + offset + quarterSize), 1);
+				}
+			}
+		}
+		break;
+	}
+	case IGameObject::EObjectType::BetonWall:
+		fillColliders(EPlane::BetonWall, object);
+		break;
+	case IGameObject::EObjectType::Water:
+		fillColliders(EPlane::Water, object);
+		break;
+	case IGameObject::EObjectType::Eagle:
+		fillColliders(EPlane::Eagle, object);
+		break;
+	case IGameObject::EObjectType::Ice:
+		fillArea(EPlane::Ice, Physics::AABB(position, position + object.getSize()), 1);
+		break;
+	case IGameObject::EObjectType::Trees:
+		fillArea(EPlane::Trees, Physics::AABB(position, position + object.getSize()), 1);
+		break;
+	default:
+		break;
+	}
+}
+
+void ObservationEncoder::fillCells(const EPlane ePlane, const glm::ivec2& min, const glm::ivec2& max, const uint8_t value) {
+	if (min.x >= max.x) {
+		return;
+	}
+	const size_t widthCells = getWidthCells();
+	uint8_t* plane = m_planes + static_cast<size_t>(ePlane) * widthCells * getHeightCells();
+	for (int currentY = min.y; currentY < max.y; ++currentY) {
+		std::memset(plane + currentY * widthCells + min.x, value, max.x - min.x);
+	}
+}
+
+void ObservationEncoder::fillColliders(const EPlane ePlane, IGameObject& object) {
+	const glm::vec2& position = object.getCurrentPosition();
+	for (const auto& collider : object.getColliders()) {
+		if (collider.isActive) {
+			fillArea(ePlane, Physics::AABB(position + collider.boundingBox.bottomLeft, position + collider.boundingBox.topRight), 1);
+		}
+	}
+}
+
+void ObservationEncoder::fillArea(const EPlane ePlane, const Physics::AABB& area, const uint8_t value) {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	m_grid->getCells(area, min, max);
+	fillCells(ePlane, min, max, value);
+}
\ No newline at end of file
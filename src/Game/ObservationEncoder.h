@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+#include "../Physics/PhysicsEngine.h"
+
+class NavigationGrid;
+class IGameObject;
+
+// The level as a stack of planes over the cells of the navigation grid, a byte per cell,
+// for agents that learn from symbols instead of pixels. A cell is a quarter of a brick, so
+// the brick plane follows the walls as they get shot away. Row 0 is the bottom of the level.
+// The buffer belongs to the caller; while it holds the previous encoding only the terrain that
+// changed since then and the cells of the tanks and bullets are written again.
+class ObservationEncoder {
+public:
+	enum class EPlane : uint8_t {
+		BrickWall,
+		BetonWall,
+		Water,
+		Ice,
+		Trees,
+		Eagle,
+		// tanks by faction and orientation, bullets by direction, in the order of the tank orientations
+		PlayerTop,
+		PlayerBottom,
+		PlayerLeft,
+		PlayerRight,
+		EnemyTop,
+		EnemyBottom,
+		EnemyLeft,
+		EnemyRight,
+		BulletTop,
+		BulletBottom,
+		BulletLeft,
+		BulletRight,
+		Count
+	};
+
+	static constexpr size_t PLANES_COUNT = static_cast<size_t>(EPlane::Count);
+	static constexpr size_t TERRAIN_PLANES_COUNT = static_cast<size_t>(EPlane::PlayerTop);
+
+	// maxDynamicObjects tanks and bullets are encoded without allocating
+	ObservationEncoder(const NavigationGrid* grid, const size_t maxDynamicObjects);
+
+	// forgets the terrain, the grid has to be reset first
+	void reset();
+	void addTerrain(IGameObject& object);
+	// the object is encoded again by the next encoding
+	void markTerrainChanged(IGameObject& object);
+
+	size_t getWidthCells() const;
+	size_t getHeightCells() const;
+	// bytes of an encoding, planes x rows x columns
+	size_t getSize() const { return PLANES_COUNT * getWidthCells() * getHeightCells(); }
+
+	// writes the terrain and clears the tanks and bullets of the last encoding;
+	// isBufferCurrent means the buffer still holds the last encoding of this encoder
+	void beginEncode(uint8_t* planes, const bool isBufferCurrent);
+	void addTank(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction, const bool isPlayer);
+	void addBullet(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction);
+
+private:
+	struct DrawnArea {
+		glm::ivec2 min;
+		glm::ivec2 max;
+		EPlane ePlane;
+	};
+
+	void drawTerrain(IGameObject& object);
+	void drawDynamicObject(const EPlane ePlane, const Physics::AABB& area);
+	// cells [min, max) of the plane, a row at a time
+	void fillCells(const EPlane ePlane, const glm::ivec2& min, const glm::ivec2& max, const uint8_t value);
+	void fillArea(const EPlane ePlane, const Physics::AABB& area, const uint8_t value);
+	void fillColliders(const EPlane ePlane, IGameObject& object);
+
+	const NavigationGrid* m_grid;
+	uint8_t* m_planes;
+	std::vector<IGameObject*> m_terrain;
+	// terrain changed since the last encoding, the whole terrain is encoded again if it overflows
+	std::vector<IGameObject*> m_changedTerrain;
+	bool m_isTerrainChanged;
+	// cells of the tanks and bullets of the last encoding
+	std::vector<DrawnArea> m_drawnAreas;
+};
\ No newline at end of file
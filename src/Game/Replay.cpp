@@ -0,0 +1,327 @@
+#include "Replay.h"
+
+#include <iostream>
+#include <iterator>
+#include <cstring>
+
+#include "WorldState.h"
+
+// flags of a block
+static constexpr uint8_t FLAG_KEYS = 1 << 0;
+static constexpr uint8_t FLAG_AGENT_ACTIONS = 1 << 1;
+static constexpr uint8_t FLAG_AGENT_RESET = 1 << 2;
+static constexpr uint8_t FLAG_END = 1 << 7;
+
+// flags of the header
+static constexpr uint8_t HEADER_STARTS_IN_LEVEL = 1 << 0;
+static constexpr uint8_t HEADER_HAS_AGENT = 1 << 1;
+
+// the buffer is written to the file once it grows this large (bytes)
+static constexpr size_t FLUSH_SIZE = 64 * 1024;
+
+static void appendFixed(std::vector<uint8_t>& buffer, const uint64_t value, const size_t bytesCount) {
+	for (size_t currentByte = 0; currentByte < bytesCount; ++currentByte) {
+		buffer.push_back(static_cast<uint8_t>(value >> (8 * currentByte)));
+	}
+}
+
+static uint64_t getFixed(const uint8_t* data, const size_t bytesCount) {
+	uint64_t value = 0;
+	for (size_t currentByte = 0; currentByte < bytesCount; ++currentByte) {
+		value |= static_cast<uint64_t>(data[currentByte]) << (8 * currentByte);
+	}
+	return value;
+}
+
+static bool isSameAction(const Agent::Action& action1, const Agent::Action& action2) {
+	return action1.directionX == action2.directionX && action1.directionY == action2.directionY && action1.fire == action2.fire;
+}
+
+// hashes the fields one by one, the padding and the unused entries of the state are not defined
+static void hashBytes(uint64_t& hash, const void* data, const size_t size) {
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	for (size_t currentByte = 0; currentByte < size; ++currentByte) {
+		hash = (hash ^ bytes[currentByte]) * 1099511628211ull;
+	}
+}
+
+template <class T>
+static void hashValue(uint64_t& hash, const T& value) {
+	hashBytes(hash, &value, sizeof(value));
+}
+
+uint64_t Replay::getChecksum(const WorldState* worldState) {
+	if (!worldState) {
+		return 0;
+	}
+	uint64_t hash = 14695981039346656037ull;
+	hashBytes(hash, worldState->tankBlockedRows.data(), worldState->heightCells * sizeof(uint64_t));
+	hashBytes(hash, worldState->bulletBlockedRows.data(), worldState->heightCells * sizeof(uint64_t));
+	hashBytes(hash, worldState->destructibleRows.data(), worldState->heightCells * sizeof(uint64_t));
+	hashValue(hash, worldState->origin);
+	hashValue(hash, worldState->cellSize);
+	hashValue(hash, worldState->widthCells);
+	hashValue(hash, worldState->heightCells);
+	for (size_t currentTank = 0; currentTank < worldState->tanksCount; ++currentTank) {
+		const WorldState::Tank& tank = worldState->tanks[currentTank];
+		hashValue(hash, tank.position);
+		hashValue(hash, tank.size);
+		hashValue(hash, tank.direction);
+		hashValue(hash, tank.velocity);
+		hashValue(hash, tank.maxVelocity);
+		hashValue(hash, tank.bulletsInFlight);
+		hashValue(hash, tank.maxBullets);
+		hashValue(hash, tank.hasAI);
+		hashValue(hash, tank.isInvulnerable);
+		hashValue(hash, tank.isDestroyed);
+	}
+	for (size_t currentBullet = 0; currentBullet < worldState->bulletsCount; ++currentBullet) {
+		const WorldState::Bullet& bullet = worldState->bullets[currentBullet];
+		hashValue(hash, bullet.position);
+		hashValue(hash, bullet.size);
+		hashValue(hash, bullet.direction);
+		hashValue(hash, bullet.velocity);
+		hashValue(hash, bullet.owner);
+	}
+	hashValue(hash, worldState->tanksCount);
+	hashValue(hash, worldState->bulletsCount);
+	hashValue(hash, worldState->bulletVelocity);
+	hashValue(hash, worldState->time);
+	return hash;
+}
+
+std::unique_ptr<ReplayRecorder> ReplayRecorder::create(const std::string& path, const Replay::Header& header) {
+	std::ofstream file(path, std::ios::binary | std::ios::trunc);
+	if (!file.is_open()) {
+		std::cerr << "Can't create replay: " << path << std::endl;
+		return nullptr;
+	}
+	return std::unique_ptr<ReplayRecorder>(new ReplayRecorder(std::move(file), header));
+}
+
+ReplayRecorder::ReplayRecorder(std::ofstream file, const Replay::Header& header)
+	: m_file(std::move(file))
+	, m_agentActions{}
+	, m_tick(0)
+	, m_lastBlockTick(0)
+	, m_isFinished(false)
+{
+	m_keys.fill(false);
+	m_buffer.reserve(FLUSH_SIZE + 1024);
+
+	appendFixed(m_buffer, Replay::MAGIC, 4);
+	m_buffer.push_back(Replay::VERSION);
+	uint64_t tickTimeBits;
+	std::memcpy(&tickTimeBits, &header.tickTime, sizeof(tickTimeBits));
+	appendFixed(m_buffer, tickTimeBits, 8);
+	m_buffer.push_back((header.startsInLevel ? HEADER_STARTS_IN_LEVEL : 0) | (header.hasAgent ? HEADER_HAS_AGENT : 0));
+	writeVarint(header.levelIndex);
+	m_buffer.push_back(header.gameMode);
+}
+
+ReplayRecorder::~ReplayRecorder() {
+	if (!m_isFinished) {
+		finish(0);
+	}
+}
+
+void ReplayRecorder::writeVarint(uint64_t value) {
+	while (value >= 0x80) {
+		m_buffer.push_back(static_cast<uint8_t>(value) | 0x80);
+		value >>= 7;
+	}
+	m_buffer.push_back(static_cast<uint8_t>(value));
+}
+
+void ReplayRecorder::flush() {
+	m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+	m_file.flush();
+	m_buffer.clear();
+}
+
+void ReplayRecorder::recordTick(const Replay::Keys& keys, const Replay::AgentActions* agentActions, const bool isAgentReset) {
+	if (m_isFinished) {
+		return;
+	}
+
+	size_t changedKeysCount = 0;
+	for (size_t currentKey = 0; currentKey < keys.size(); ++currentKey) {
+		changedKeysCount += keys[currentKey] != m_keys[currentKey];
+	}
+	bool haveAgentActionsChanged = false;
+	if (agentActions) {
+		for (size_t currentPlayer = 0; currentPlayer < Agent::MAX_PLAYERS; ++currentPlayer) {
+			haveAgentActionsChanged = haveAgentActionsChanged || !isSameAction((*agentActions)[currentPlayer], m_agentActions[currentPlayer]);
+		}
+	}
+
+	const uint8_t flags = (changedKeysCount > 0 ? FLAG_KEYS : 0) | (haveAgentActionsChanged ? FLAG_AGENT_ACTIONS : 0) | (isAgentReset ? FLAG_AGENT_RESET : 0);
+	if (flags != 0) {
+		writeVarint(m_tick - m_lastBlockTick);
+		m_buffer.push_back(flags);
+		m_lastBlockTick = m_tick;
+
+		if (changedKeysCount > 0) {
+			// the keys only flip, so their codes are enough, each as the gap from the previous one
+			writeVarint(changedKeysCount);
+			size_t previousKey = 0;
+			for (size_t currentKey = 0; currentKey < keys.size(); ++currentKey) {
+				if (keys[currentKey] != m_keys[currentKey]) {
+					writeVarint(currentKey - previousKey);
+					previousKey = currentKey;
+					m_keys[currentKey] = keys[currentKey];
+				}
+			}
+		}
+
+		if (haveAgentActionsChanged) {
+			for (const Agent::Action& currentAction : *agentActions) {
+				m_buffer.push_back(static_cast<uint8_t>(currentAction.directionX));
+				m_buffer.push_back(static_cast<uint8_t>(currentAction.directionY));
+				m_buffer.push_back(currentAction.fire);
+			}
+			m_agentActions = *agentActions;
+		}
+	}
+
+	++m_tick;
+	if (m_buffer.size() >= FLUSH_SIZE) {
+		flush();
+	}
+}
+
+void ReplayRecorder::finish(const uint64_t worldChecksum) {
+	if (m_isFinished) {
+		return;
+	}
+	writeVarint(m_tick - m_lastBlockTick);
+	m_buffer.push_back(FLAG_END);
+	appendFixed(m_buffer, worldChecksum, 8);
+	flush();
+	m_isFinished = true;
+}
+
+std::unique_ptr<ReplayPlayer> ReplayPlayer::open(const std::string& path) {
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open()) {
+		std::cerr << "Can't open replay: " << path << std::endl;
+		return nullptr;
+	}
+	std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	std::unique_ptr<ReplayPlayer> player(new ReplayPlayer(std::move(data)));
+	if (!player->readHeader() || !player->readBlockStart()) {
+		std::cerr << "Not a replay: " << path << std::endl;
+		return nullptr;
+	}
+	return player;
+}
+
+ReplayPlayer::ReplayPlayer(std::vector<uint8_t> data)
+	: m_data(std::move(data))
+	, m_offset(0)
+	, m_agentActions{}
+	, m_isAgentReset(false)
+	, m_tick(0)
+	, m_nextBlockTick(0)
+	, m_nextBlockFlags(0)
+	, m_ticksCount(0)
+	, m_worldChecksum(0)
+{
+	m_keys.fill(false);
+}
+
+bool ReplayPlayer::readVarint(uint64_t& value) {
+	value = 0;
+	for (unsigned int shift = 0; shift < 64 && m_offset < m_data.size(); shift += 7) {
+		const uint8_t currentByte = m_data[m_offset++];
+		value |= static_cast<uint64_t>(currentByte & 0x7F) << shift;
+		if (!(currentByte & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool ReplayPlayer::readHeader() {
+	if (m_data.size() < 14 || getFixed(m_data.data(), 4) != Replay::MAGIC || m_data[4] != Replay::VERSION) {
+		return false;
+	}
+	const uint64_t tickTimeBits = getFixed(m_data.data() + 5, 8);
+	std::memcpy(&m_header.tickTime, &tickTimeBits, sizeof(tickTimeBits));
+	const uint8_t flags = m_data[13];
+	m_header.startsInLevel = flags & HEADER_STARTS_IN_LEVEL;
+	m_header.hasAgent = flags & HEADER_HAS_AGENT;
+	m_offset = 14;
+
+	uint64_t levelIndex;
+	if (!readVarint(levelIndex) || m_offset >= m_data.size()) {
+		return false;
+	}
+	m_header.levelIndex = static_cast<uint32_t>(levelIndex);
+	m_header.gameMode = m_data[m_offset++];
+	return true;
+}
+
+bool ReplayPlayer::readBlockStart() {
+	uint64_t gap;
+	if (!readVarint(gap) || m_offset >= m_data.size()) {
+		return false;
+	}
+	m_nextBlockTick += gap;
+	m_nextBlockFlags = m_data[m_offset++];
+	if (m_nextBlockFlags & FLAG_END) {
+		if (m_offset + 8 > m_data.size()) {
+			return false;
+		}
+		m_ticksCount = m_nextBlockTick;
+		m_worldChecksum = getFixed(m_data.data() + m_offset, 8);
+		m_offset += 8;
+	}
+	return true;
+}
+
+bool ReplayPlayer::advance() {
+	m_isAgentReset = false;
+	if ((m_nextBlockFlags & FLAG_END) && m_tick >= m_ticksCount) {
+		return false;
+	}
+
+	if (!(m_nextBlockFlags & FLAG_END) && m_tick == m_nextBlockTick) {
+		bool isValid = true;
+		if (m_nextBlockFlags & FLAG_KEYS) {
+			uint64_t changedKeysCount = 0;
+			isValid = readVarint(changedKeysCount);
+			uint64_t key = 0;
+			for (uint64_t currentChange = 0; isValid && currentChange < changedKeysCount; ++currentChange) {
+				uint64_t gap;
+				isValid = readVarint(gap) && key + gap < m_keys.size();
+				if (isValid) {
+					key += gap;
+					m_keys[key] = !m_keys[key];
+				}
+			}
+		}
+		if (isValid && (m_nextBlockFlags & FLAG_AGENT_ACTIONS)) {
+			isValid = m_offset + 3 * m_agentActions.size() <= m_data.size();
+			for (size_t currentPlayer = 0; isValid && currentPlayer < m_agentActions.size(); ++currentPlayer) {
+				Agent::Action& action = m_agentActions[currentPlayer];
+				action.directionX = static_cast<int8_t>(m_data[m_offset++]);
+				action.directionY = static_cast<int8_t>(m_data[m_offset++]);
+				action.fire = m_data[m_offset++];
+			}
+		}
+		m_isAgentReset = m_nextBlockFlags & FLAG_AGENT_RESET;
+
+		if (!isValid || !readBlockStart()) {
+			std::cerr << "Replay is cut off at tick " << m_tick << std::endl;
+			// what was read is still played, the replay ends after this tick
+			m_nextBlockFlags = FLAG_END;
+			m_ticksCount = m_tick + 1;
+			m_worldChecksum = 0;
+		}
+	}
+
+	++m_tick;
+	return true;
+}
\ No newline at end of file
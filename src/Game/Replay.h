@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <string>
+#include <fstream>
+#include <cstddef>
+#include <cstdint>
+
+#include "Agent/AgentProtocol.h"
+
+struct WorldState;
+
+// Input of a game played in fixed ticks, enough to play the game again tick for tick.
+// The file starts with a header and continues with a block for every tick whose input changed:
+// a varint gap in ticks since the previous block, flags, the keys that flipped as varint gaps
+// between their codes, and the actions of an attached agent. The last block closes the replay
+// and carries a checksum of the world state after the last tick.
+namespace Replay {
+
+	static constexpr uint32_t MAGIC = 0x50524342; // "BCRP"
+	static constexpr uint8_t VERSION = 1;
+	static constexpr size_t KEYS_COUNT = 349;
+
+	typedef std::array<bool, KEYS_COUNT> Keys;
+	typedef std::array<Agent::Action, Agent::MAX_PLAYERS> AgentActions;
+
+	// what the game was doing when the recording started
+	struct Header {
+		double tickTime = 0;
+		// otherwise the recording starts at the start screen
+		bool startsInLevel = false;
+		uint32_t levelIndex = 0;
+		uint8_t gameMode = 0;
+		// the players were controlled by an agent, the keys are not used
+		bool hasAgent = false;
+	};
+
+	// FNV-1a over the fields of the state in use, 0 if there is no state
+	uint64_t getChecksum(const WorldState* worldState);
+}
+
+class ReplayRecorder {
+public:
+	// nullptr if the file can't be created
+	static std::unique_ptr<ReplayRecorder> create(const std::string& path, const Replay::Header& header);
+	// closes the replay as if it was finished without a world state
+	~ReplayRecorder();
+
+	ReplayRecorder(const ReplayRecorder&) = delete;
+	ReplayRecorder& operator = (const ReplayRecorder&) = delete;
+
+	// input of the tick about to be simulated, agentActions is nullptr without an agent
+	void recordTick(const Replay::Keys& keys, const Replay::AgentActions* agentActions, const bool isAgentReset);
+	// writes the closing block, nothing is recorded afterwards
+	void finish(const uint64_t worldChecksum);
+
+private:
+	ReplayRecorder(std::ofstream file, const Replay::Header& header);
+
+	void writeVarint(uint64_t value);
+	void flush();
+
+	std::ofstream m_file;
+	std::vector<uint8_t> m_buffer;
+	Replay::Keys m_keys;
+	Replay::AgentActions m_agentActions;
+	uint64_t m_tick;
+	uint64_t m_lastBlockTick;
+	bool m_isFinished;
+};
+
+class ReplayPlayer {
+public:
+	// nullptr if the file can't be read or is not a replay
+	static std::unique_ptr<ReplayPlayer> open(const std::string& path);
+
+	const Replay::Header& getHeader() const { return m_header; }
+
+	// moves to the input of the next tick, false once every recorded tick was played
+	bool advance();
+	const Replay::Keys& getKeys() const { return m_keys; }
+	const Replay::AgentActions& getAgentActions() const { return m_agentActions; }
+	bool isAgentReset() const { return m_isAgentReset; }
+
+	uint64_t getTick() const { return m_tick; }
+	uint64_t getTicksCount() const { return m_ticksCount; }
+	// checksum of the world state after the last tick of the recording
+	uint64_t getWorldChecksum() const { return m_worldChecksum; }
+
+private:
+	ReplayPlayer(std::vector<uint8_t> data);
+
+	bool readVarint(uint64_t& value);
+	bool readHeader();
+	// reads the gap and the flags of the next block, the closing block is read whole
+	bool readBlockStart();
+
+	std::vector<uint8_t> m_data;
+	size_t m_offset;
+	Replay::Header m_header;
+	Replay::Keys m_keys;
+	Replay::AgentActions m_agentActions;
+	bool m_isAgentReset;
+	// ticks advanced so far, the current tick is m_tick - 1
+	uint64_t m_tick;
+	uint64_t m_nextBlockTick;
+	uint8_t m_nextBlockFlags;
+	uint64_t m_ticksCount;
+	uint64_t m_worldChecksum;
+};
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "ThreatMap.h"
+
+#include "FlowField.h"
+
+#include <algorithm>
+
+ThreatMap::ThreatMap(const NavigationGrid* grid)
+	: m_grid(grid)
+{
+}
+
+void ThreatMap::reset() {
+	const size_t widthCells = m_grid->getWidthCells();
+	const size_t heightCells = m_grid->getHeightCells();
+	m_solidRows.reset(widthCells, heightCells);
+	m_solidColumns.reset(heightCells, widthCells);
+	m_destructibleRows.reset(widthCells, heightCells);
+	for (auto& currentThreats : m_threats) {
+		currentThreats.reset(widthCells, heightCells);
+	}
+	m_targets.clear();
+}
+
+void ThreatMap::setArea(const Physics::AABB& area, const bool isSolid, const bool isDestructible) {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	m_grid->getCells(area, min, max);
+	for (int currentY = min.y; currentY < max.y; ++currentY) {
+		m_solidRows.setRange(currentY, min.x, max.x, isSolid);
+		m_destructibleRows.setRange(currentY, min.x, max.x, isSolid && isDestructible);
+	}
+	for (int currentX = min.x; currentX < max.x; ++currentX) {
+		m_solidColumns.setRange(currentX, min.y, max.y, isSolid);
+	}
+}
+
+void ThreatMap::clearTick() {
+	for (auto& currentThreats : m_threats) {
+		currentThreats.clear();
+	}
+	m_targets.clear();
+}
+
+ThreatMap::EDirection ThreatMap::getDirection(const glm::ivec2& direction) {
+	if (direction.y > 0) {
+		return EDirection::Top;
+	}
+	if (direction.y < 0) {
+		return EDirection::Bottom;
+	}
+	return direction.x < 0 ? EDirection::Left : EDirection::Right;
+}
+
+int ThreatMap::findObstacle(const glm::ivec2& min, const glm::ivec2& max, const EDirection eDirection, int& obstacleLine, int& obstacle) const {
+	const bool isHorizontal = eDirection == EDirection::Left || eDirection == EDirection::Right;
+	const Bitboard& lines = isHorizontal ? m_solidRows : m_solidColumns;
+	const int firstLine = isHorizontal ? min.y : min.x;
+	const int lastLine = isHorizontal ? max.y : max.x;
+	obstacleLine = firstLine;
+
+	if (eDirection == EDirection::Right || eDirection == EDirection::Top) {
+		const int start = isHorizontal ? min.x : min.y;
+		obstacle = static_cast<int>(lines.getLineLength());
+		for (int currentLine = firstLine; currentLine < lastLine; ++currentLine) {
+			const int found = lines.findForward(currentLine, start);
+			if (found != Bitboard::NOT_FOUND && found < obstacle) {
+				obstacle = found;
+				obstacleLine = currentLine;
+			}
+		}
+		return std::max(obstacle - start, 0);
+	}
+
+	const int start = (isHorizontal ? max.x : max.y) - 1;
+	obstacle = -1;
+	for (int currentLine = firstLine; start >= 0 && currentLine < lastLine; ++currentLine) {
+		const int found = lines.findBackward(currentLine, start);
+		if (found > obstacle) {
+			obstacle = found;
+			obstacleLine = currentLine;
+		}
+	}
+	return std::max(start - obstacle, 0);
+}
+
+void ThreatMap::addBullet(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction) {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	m_grid->getCells(Physics::AABB(position, position + size), min, max);
+	const EDirection eDirection = getDirection(glm::ivec2(direction));
+	int obstacleLine;
+	int obstacle;
+	findObstacle(min, max, eDirection, obstacleLine, obstacle);
+
+	// the path of the bullet up to the cell it explodes at
+	Bitboard& threats = m_threats[static_cast<size_t>(eDirection)];
+	switch (eDirection)
+	{
+	case EDirection::Right:
+		for (int currentY = min.y; currentY < max.y; ++currentY) {
+			threats.setRange(currentY, min.x, std::max(obstacle, min.x), true);
+		}
+		break;
+	case EDirection::Left:
+		for (int currentY = min.y; currentY < max.y; ++currentY) {
+			threats.setRange(currentY, std::min(obstacle + 1, max.x), max.x, true);
+		}
+		break;
+	case EDirection::Top:
+		for (int currentY = min.y; currentY < obstacle; ++currentY) {
+			threats.setRange(currentY, min.x, max.x, true);
+		}
+		break;
+	default:
+		for (int currentY = obstacle + 1; currentY < max.y; ++currentY) {
+			threats.setRange(currentY, min.x, max.x, true);
+		}
+		break;
+	}
+}
+
+void ThreatMap::addTarget(const Physics::AABB& target) {
+	m_targets.push_back(target);
+}
+
+ThreatMap::LineOfFire ThreatMap::getLineOfFire(const Physics::AABB& lane, const glm::ivec2& direction) const {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	m_grid->getCells(lane, min, max);
+	const EDirection eDirection = getDirection(direction);
+	int obstacleLine;
+	int obstacle;
+
+	LineOfFire lineOfFire;
+	lineOfFire.freeCells = findObstacle(min, max, eDirection, obstacleLine, obstacle);
+
+	const bool isHorizontal = eDirection == EDirection::Left || eDirection == EDirection::Right;
+	const glm::ivec2 obstacleCell = isHorizontal ? glm::ivec2(obstacle, obstacleLine) : glm::ivec2(obstacleLine, obstacle);
+	if (obstacleCell.x >= 0 && obstacleCell.y >= 0 && obstacleCell.x < static_cast<int>(m_grid->getWidthCells()) && obstacleCell.y < static_cast<int>(m_grid->getHeightCells())) {
+		lineOfFire.isObstacleDestructible = m_destructibleRows.get(obstacleCell.y, obstacleCell.x);
+	}
+
+	for (const auto& currentTarget : m_targets) {
+		glm::ivec2 targetMin;
+		glm::ivec2 targetMax;
+		m_grid->getCells(currentTarget, targetMin, targetMax);
+		// cells of the target in front of the lane, from the start of the lane
+		int distance;
+		switch (eDirection)
+		{
+		case EDirection::Right:
+			distance = targetMax.x > min.x && targetMin.y < max.y && targetMax.y > min.y ? std::max(targetMin.x - min.x, 0) : -1;
+			break;
+		case EDirection::Left:
+			distance = targetMin.x < max.x && targetMin.y < max.y && targetMax.y > min.y ? std::max(max.x - targetMax.x, 0) : -1;
+			break;
+		case EDirection::Top:
+			distance = targetMax.y > min.y && targetMin.x < max.x && targetMax.x > min.x ? std::max(targetMin.y - min.y, 0) : -1;
+			break;
+		default:
+			distance = targetMin.y < max.y && targetMin.x < max.x && targetMax.x > min.x ? std::max(max.y - targetMax.y, 0) : -1;
+			break;
+		}
+		if (distance >= 0 && distance <= lineOfFire.freeCells) {
+			lineOfFire.hasTarget = true;
+			break;
+		}
+	}
+	return lineOfFire;
+}
+
+uint8_t ThreatMap::getThreats(const Physics::AABB& area) const {
+	glm::ivec2 min;
+	glm::ivec2 max;
+	m_grid->getCells(area, min, max);
+	uint8_t threats = 0;
+	for (size_t currentDirection = 0; currentDirection < m_threats.size(); ++currentDirection) {
+		for (int currentY = min.y; currentY < max.y; ++currentY) {
+			if (m_threats[currentDirection].hasAny(currentY, min.x, max.x)) {
+				threats |= 1 << currentDirection;
+				break;
+			}
+		}
+	}
+	return threats;
+}
\ No newline at end of file
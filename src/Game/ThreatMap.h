@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <glm/vec2.hpp>
+
+#include "../Physics/PhysicsEngine.h"
+#include "../System/Bitboard.h"
+
+class NavigationGrid;
+
+// Line of sight and bullet paths on the cells of the navigation grid, shared by all AI.
+// Tanks and bullets only move along the axes, so every query is a scan of a few
+// rows or columns of bitboards. The terrain changes with the level, the bullet paths
+// and the targets are rebuilt every tick before the AI decides.
+class ThreatMap {
+public:
+	// directions of the scans and of the bullets, in the order of the tank orientations
+	enum class EDirection : uint8_t {
+		Top,
+		Bottom,
+		Left,
+		Right,
+		Count
+	};
+
+	struct LineOfFire {
+		// free cells in front of the lane
+		int freeCells = 0;
+		// the first obstacle can be shot away
+		bool isObstacleDestructible = false;
+		// a target is closer than the first obstacle
+		bool hasTarget = false;
+	};
+
+	explicit ThreatMap(const NavigationGrid* grid);
+
+	// clears the map, the grid has to be reset first
+	void reset();
+	// cells stopping bullets, destructible ones can be shot away
+	void setArea(const Physics::AABB& area, const bool isSolid, const bool isDestructible);
+	bool isSolid(const glm::ivec2& cell) const { return m_solidRows.get(cell.y, cell.x); }
+	bool isDestructible(const glm::ivec2& cell) const { return m_destructibleRows.get(cell.y, cell.x); }
+
+	void clearTick();
+	void addBullet(const glm::vec2& position, const glm::vec2& size, const glm::vec2& direction);
+	void addTarget(const Physics::AABB& target);
+
+	// what a bullet covering the lane and moving in the direction would meet
+	LineOfFire getLineOfFire(const Physics::AABB& lane, const glm::ivec2& direction) const;
+	// bit (1 << EDirection) is set for every direction of the bullets going through the area
+	uint8_t getThreats(const Physics::AABB& area) const;
+	bool isThreatened(const Physics::AABB& area) const { return getThreats(area) != 0; }
+
+	static EDirection getDirection(const glm::ivec2& direction);
+
+private:
+	// distance in cells from the start of the lane to the first solid cell along the direction,
+	// the cell found is returned in obstacle (-1 or the size of the grid past the edge)
+	int findObstacle(const glm::ivec2& min, const glm::ivec2& max, const EDirection eDirection, int& obstacleLine, int& obstacle) const;
+
+	const NavigationGrid* m_grid;
+	// solid cells by rows and by columns, for the horizontal and the vertical scans
+	Bitboard m_solidRows;
+	Bitboard m_solidColumns;
+	Bitboard m_destructibleRows;
+	// bullet paths by rows, one board per direction of the bullets
+	std::array<Bitboard, static_cast<size_t>(EDirection::Count)> m_threats;
+	std::vector<Physics::AABB> m_targets;
+};
\ No newline at end of file
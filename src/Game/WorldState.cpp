@@ -0,0 +1,151 @@
+#include "WorldState.h"
+
+#include <algorithm>
+#include <cmath>
+
+// keeps positions lying exactly on a cell border from reaching into the neighbor cell
+static constexpr float CELL_EPSILON = 0.001f;
+
+static uint64_t getRowMask(const int min, const int max) {
+	const int count = max - min;
+	if (count <= 0) {
+		return 0;
+	}
+	return (count >= 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << min;
+}
+
+WorldState::Actions WorldState::getCurrentActions() const {
+	Actions actions{};
+	for (size_t currentTank = 0; currentTank < tanksCount; ++currentTank) {
+		actions[currentTank].direction = glm::ivec2(tanks[currentTank].direction);
+		actions[currentTank].move = tanks[currentTank].velocity > 0;
+		actions[currentTank].fire = false;
+	}
+	return actions;
+}
+
+void WorldState::getCells(const glm::vec2& position, const glm::vec2& size, glm::ivec2& min, glm::ivec2& max) const {
+	const glm::vec2 bottomLeft = (position - origin) / cellSize;
+	const glm::vec2 topRight = (position + size - origin) / cellSize;
+	min.x = std::clamp(static_cast<int>(std::floor(bottomLeft.x + CELL_EPSILON)), 0, static_cast<int>(widthCells));
+	min.y = std::clamp(static_cast<int>(std::floor(bottomLeft.y + CELL_EPSILON)), 0, static_cast<int>(heightCells));
+	max.x = std::clamp(static_cast<int>(std::ceil(topRight.x - CELL_EPSILON)), 0, static_cast<int>(widthCells));
+	max.y = std::clamp(static_cast<int>(std::ceil(topRight.y - CELL_EPSILON)), 0, static_cast<int>(heightCells));
+}
+
+bool WorldState::isBlocked(const std::array<uint64_t, MAX_CELLS>& rows, const glm::vec2& position, const glm::vec2& size) const {
+	// the level ends at the edges of the grid
+	const glm::vec2 levelEnd = origin + glm::vec2(widthCells, heightCells) * cellSize;
+	if (position.x < origin.x - CELL_EPSILON || position.y < origin.y - CELL_EPSILON
+		|| position.x + size.x > levelEnd.x + CELL_EPSILON || position.y + size.y > levelEnd.y + CELL_EPSILON) {
+		return true;
+	}
+
+	glm::ivec2 min;
+	glm::ivec2 max;
+	getCells(position, size, min, max);
+	const uint64_t mask = getRowMask(min.x, max.x);
+	for (int currentY = min.y; currentY < max.y; ++currentY) {
+		if (rows[currentY] & mask) {
+			return true;
+		}
+	}
+	return false;
+}
+
+bool WorldState::overlapsTank(const size_t tankIndex, const glm::vec2& position, const glm::vec2& size) const {
+	for (size_t currentTank = 0; currentTank < tanksCount; ++currentTank) {
+		const Tank& other = tanks[currentTank];
+		if (currentTank != tankIndex && !other.isDestroyed
+			&& position.x < other.position.x + other.size.x && other.position.x < position.x + size.x
+			&& position.y < other.position.y + other.size.y && other.position.y < position.y + size.y) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void WorldState::removeBullet(const size_t bulletIndex) {
+	const uint8_t owner = bullets[bulletIndex].owner;
+	if (owner != NO_TANK && tanks[owner].bulletsInFlight > 0) {
+		--tanks[owner].bulletsInFlight;
+	}
+	bullets[bulletIndex] = bullets[--bulletsCount];
+}
+
+void WorldState::step(const Actions& actions, const float delta) {
+	time += delta;
+
+	for (size_t currentTankIndex = 0; currentTankIndex < tanksCount; ++currentTankIndex) {
+		Tank& tank = tanks[currentTankIndex];
+		const Action& action = actions[currentTankIndex];
+		if (tank.isDestroyed) {
+			continue;
+		}
+
+		if (action.direction != glm::ivec2(0, 0)) {
+			tank.direction = glm::vec2(action.direction);
+		}
+		tank.velocity = action.move ? tank.maxVelocity : 0.f;
+		const glm::vec2 position = tank.position + tank.direction * tank.velocity * delta;
+		if (!isBlocked(tankBlockedRows, position, tank.size) && !overlapsTank(currentTankIndex, position, tank.size)) {
+			tank.position = position;
+		}
+
+		if (action.fire && tank.bulletsInFlight < tank.maxBullets && bulletsCount < MAX_BULLETS) {
+			// the same muzzle as Tank::fire
+			Bullet& bullet = bullets[bulletsCount++];
+			bullet.position = tank.position + tank.size / 4.f + tank.size * tank.direction / 4.f;
+			bullet.size = tank.size / 2.f;
+			bullet.direction = tank.direction;
+			bullet.velocity = bulletVelocity;
+			bullet.owner = static_cast<uint8_t>(currentTankIndex);
+			++tank.bulletsInFlight;
+		}
+	}
+
+	for (size_t currentBulletIndex = bulletsCount; currentBulletIndex-- > 0;) {
+		Bullet& bullet = bullets[currentBulletIndex];
+		bullet.position += bullet.direction * bullet.velocity * delta;
+
+		if (isBlocked(bulletBlockedRows, bullet.position, bullet.size)) {
+			// bricks hit by the bullet are gone
+			glm::ivec2 min;
+			glm::ivec2 max;
+			getCells(bullet.position, bullet.size, min, max);
+			const uint64_t mask = getRowMask(min.x, max.x);
+			for (int currentY = min.y; currentY < max.y; ++currentY) {
+				const uint64_t destroyed = destructibleRows[currentY] & mask;
+				destructibleRows[currentY] &= ~destroyed;
+				bulletBlockedRows[currentY] &= ~destroyed;
+				tankBlockedRows[currentY] &= ~destroyed;
+			}
+			removeBullet(currentBulletIndex);
+			continue;
+		}
+
+		for (size_t currentTankIndex = 0; currentTankIndex < tanksCount; ++currentTankIndex) {
+			Tank& tank = tanks[currentTankIndex];
+			if (currentTankIndex == bullet.owner || tank.isDestroyed
+				|| bullet.position.x >= tank.position.x + tank.size.x || tank.position.x >= bullet.position.x + bullet.size.x
+				|| bullet.position.y >= tank.position.y + tank.size.y || tank.position.y >= bullet.position.y + bullet.size.y) {
+				continue;
+			}
+			// only enemies can be destroyed, and only by bullets of the players
+			if (tank.hasAI && bullet.owner != NO_TANK && !tanks[bullet.owner].hasAI && !tank.isInvulnerable) {
+				tank.isDestroyed = true;
+			}
+			removeBullet(currentBulletIndex);
+			break;
+		}
+	}
+}
+
+void WorldState::simulate(Actions actions, const double duration, const float stepTime) {
+	for (double simulatedTime = 0; simulatedTime < duration; simulatedTime += stepTime) {
+		step(actions, static_cast<float>(std::min<double>(stepTime, duration - simulatedTime)));
+		for (auto& currentAction : actions) {
+			currentAction.fire = false;
+		}
+	}
+}
\ No newline at end of file
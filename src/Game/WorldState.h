@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <glm/vec2.hpp>
+
+// Copy of what decides fights on a level: terrain on the navigation cells, tanks and bullets.
+// It holds no pointers or callbacks and is trivially copyable, so a clone is one memcpy of a few KB
+// that can be stepped ahead by a simplified simulation without touching the live game.
+struct WorldState {
+	static constexpr size_t MAX_CELLS = 64;
+	static constexpr size_t MAX_TANKS = 8;
+	static constexpr size_t MAX_BULLETS = 32;
+	static constexpr uint8_t NO_TANK = 0xFF;
+
+	struct Tank {
+		glm::vec2 position;
+		glm::vec2 size;
+		glm::vec2 direction;
+		float velocity;
+		float maxVelocity;
+		uint8_t bulletsInFlight;
+		uint8_t maxBullets;
+		bool hasAI;
+		// spawning or shielded
+		bool isInvulnerable;
+		bool isDestroyed;
+	};
+
+	struct Bullet {
+		glm::vec2 position;
+		glm::vec2 size;
+		glm::vec2 direction;
+		float velocity;
+		uint8_t owner;
+	};
+
+	// what a tank does during a step
+	struct Action {
+		// (0, 0) keeps the current direction
+		glm::ivec2 direction;
+		bool move;
+		bool fire;
+	};
+
+	typedef std::array<Action, MAX_TANKS> Actions;
+
+	// a cell per bit, bit x of row y
+	std::array<uint64_t, MAX_CELLS> tankBlockedRows;
+	std::array<uint64_t, MAX_CELLS> bulletBlockedRows;
+	std::array<uint64_t, MAX_CELLS> destructibleRows;
+	glm::vec2 origin;
+	float cellSize;
+	uint8_t widthCells;
+	uint8_t heightCells;
+
+	std::array<Tank, MAX_TANKS> tanks;
+	std::array<Bullet, MAX_BULLETS> bullets;
+	uint8_t tanksCount;
+	uint8_t bulletsCount;
+	float bulletVelocity;
+	double time;
+
+	// every tank keeps doing what it does now
+	Actions getCurrentActions() const;
+	void step(const Actions& actions, const float delta);
+	// steps with the same actions until the time is simulated, firing only on the first step
+	void simulate(Actions actions, const double duration, const float stepTime);
+
+private:
+	bool isBlocked(const std::array<uint64_t, MAX_CELLS>& rows, const glm::vec2& position, const glm::vec2& size) const;
+	void getCells(const glm::vec2& position, const glm::vec2& size, glm::ivec2& min, glm::ivec2& max) const;
+	bool overlapsTank(const size_t tankIndex, const glm::vec2& position, const glm::vec2& size) const;
+	void removeBullet(const size_t bulletIndex);
+};
+
+static_assert(std::is_trivially_copyable<WorldState>::value, "world states are cloned by copying their bytes");
\ No newline at end of file
@@ -3,92 +3,211 @@
 #include "../Game/GameObjects/IGameObject.h"
 #include "../Game/GameStates/Level.h"
 
+#include <algorithm>
+
 namespace Physics {
 
-	std::unordered_set<std::shared_ptr<IGameObject>> PhysicsEngine::m_dynamicObjects;
-	std::shared_ptr<Level> PhysicsEngine::m_currentLevel;
+	PhysicsWorld PhysicsEngine::m_defaultWorld;
+	thread_local PhysicsWorld* PhysicsEngine::m_currentWorld = &PhysicsEngine::m_defaultWorld;
 
 	void PhysicsEngine::init() {
 
 	}
 
 	void PhysicsEngine::terminate() {
-		m_dynamicObjects.clear();
-		m_currentLevel.reset();
+		clearDynamicObjects();
+		m_currentWorld->currentLevel.reset();
+	}
+
+	PhysicsWorld* PhysicsEngine::setCurrentWorld(PhysicsWorld* world) {
+		PhysicsWorld* previousWorld = m_currentWorld;
+		m_currentWorld = world ? world : &m_defaultWorld;
+		return previousWorld;
 	}
 
 	void PhysicsEngine::setCurrentLevel(std::shared_ptr<Level> level) {
-		m_currentLevel.swap(level);
-		m_dynamicObjects.clear();
-		m_currentLevel->initLevel();
+		m_currentWorld->currentLevel.swap(level);
+		clearDynamicObjects();
+		m_currentWorld->currentLevel->initLevel();
+	}
+
+	void PhysicsEngine::clearDynamicObjects() {
+		for (const auto& currentDynamicObject : m_currentWorld->dynamicObjects) {
+			currentDynamicObject->m_physicsIndex = IGameObject::INVALID_PHYSICS_INDEX;
+		}
+		m_currentWorld->dynamicObjects.clear();
 	}
 
 	void PhysicsEngine::update(const double delta) {
-		calculateTargetPositions(m_dynamicObjects, delta);
+		auto& bodies = m_currentWorld->bodies;
+		gatherBodies(*m_currentWorld);
+		calculateTargetPositions(bodies, delta);
+		sortIntoChunks(*m_currentWorld);
 
-		for (auto it1 = m_dynamicObjects.begin(); it1 != m_dynamicObjects.end();) {
-			auto object1 = *it1;
-			for (auto it2 = ++it1; it2 != m_dynamicObjects.end(); ++it2) {
-				auto object2 = *it2;
-				if (object1->getOwner() == object2.get() || object2->getOwner() == object1.get()) {
+		for (size_t index1 = 0; index1 < bodies.size(); ++index1) {
+			const DynamicBody& body1 = bodies[index1];
+			findPairCandidates(*m_currentWorld, index1);
+			for (const size_t index2 : m_currentWorld->pairCandidates) {
+				const DynamicBody& body2 = bodies[index2];
+				if (body1.object->isOwnedBy(*body2.object) || body2.object->isOwnedBy(*body1.object)) {
 					continue;
 				}
 
-				if (!hasPositionIntersection(object1, object1->getTargetPosition(),
-											object2, object2->getTargetPosition())) {
+				if (!hasPositionIntersection(*body1.colliders, *body1.targetPosition,
+											*body2.colliders, *body2.targetPosition)) {
 					continue;
 				}
 
-				if (!hasPositionIntersection(object1, object1->getTargetPosition(),
-											object2, object2->getCurrentPosition())) {
-					object1->getTargetPosition() = object1->getCurrentPosition();
+				notifyCollision(body1, body2);
+
+				if (!hasPositionIntersection(*body1.colliders, *body1.targetPosition,
+											*body2.colliders, *body2.position)) {
+					*body1.targetPosition = *body1.position;
 				}
 
-				if (!hasPositionIntersection(object1, object1->getCurrentPosition(),
-											object2, object2->getTargetPosition())) {
-					object2->getTargetPosition() = object2->getCurrentPosition();
+				if (!hasPositionIntersection(*body1.colliders, *body1.position,
+											*body2.colliders, *body2.targetPosition)) {
+					*body2.targetPosition = *body2.position;
 				}
 			}
 		}
 
-		updatePositions(m_dynamicObjects);
+		updatePositions(bodies);
+	}
+
+	void PhysicsEngine::gatherBodies(PhysicsWorld& world) {
+		world.bodies.clear();
+		for (const auto& currentDynamicObject : world.dynamicObjects) {
+			world.bodies.push_back({ currentDynamicObject.get(),
+									 &currentDynamicObject->getCurrentPosition(),
+									 &currentDynamicObject->getTargetPosition(),
+									 &currentDynamicObject->getCurrentDirection(),
+									 &currentDynamicObject->getColliders() });
+		}
+	}
+
+	void PhysicsEngine::sortIntoChunks(PhysicsWorld& world) {
+		const Level& level = *world.currentLevel;
+		const size_t objectsCount = world.dynamicObjects.size();
+		world.objectChunks.resize(objectsCount);
+		world.chunkStarts.assign(level.getWidthChunks() * level.getHeightChunks() + 1, 0);
+		world.chunkObjects.resize(objectsCount);
+
+		// counting sort: the counts are summed up into the ends of the chunks,
+		// filling them backwards leaves every chunk in the order of the dynamic objects
+		for (size_t index = 0; index < objectsCount; ++index) {
+			world.objectChunks[index] = level.getChunkIndexAt(*world.bodies[index].position);
+			++world.chunkStarts[world.objectChunks[index]];
+		}
+		for (size_t chunkIndex = 1; chunkIndex < world.chunkStarts.size(); ++chunkIndex) {
+			world.chunkStarts[chunkIndex] += world.chunkStarts[chunkIndex - 1];
+		}
+		for (size_t index = objectsCount; index > 0; --index) {
+			world.chunkObjects[--world.chunkStarts[world.objectChunks[index - 1]]] = index - 1;
+		}
 	}
 
-	void PhysicsEngine::calculateTargetPositions(std::unordered_set<std::shared_ptr<IGameObject>>& dynamicObjects, const double delta) {
-		for (auto& currentDynamicObject : dynamicObjects) {
-			if (currentDynamicObject->getCurrentVelocity() > 0) {
-				if (currentDynamicObject->getCurrentDirection().x != 0.f) {
-					currentDynamicObject->getTargetPosition() = glm::vec2(currentDynamicObject->getCurrentPosition().x, static_cast<unsigned int>(currentDynamicObject->getCurrentPosition().y / 4.f + 0.5f) * 4.f);
+	void PhysicsEngine::findPairCandidates(PhysicsWorld& world, const size_t index) {
+		world.pairCandidates.clear();
+
+		// tanks and bullets are far smaller than a chunk and move much less than one per tick,
+		// so two of them that can touch are always in the same or neighbouring chunks
+		const size_t widthChunks = world.currentLevel->getWidthChunks();
+		const size_t heightChunks = world.currentLevel->getHeightChunks();
+		const size_t chunkX = world.objectChunks[index] % widthChunks;
+		const size_t chunkY = world.objectChunks[index] / widthChunks;
+		const size_t startX = chunkX > 0 ? chunkX - 1 : 0;
+		const size_t endX = std::min(chunkX + 2, widthChunks);
+		const size_t startY = chunkY > 0 ? chunkY - 1 : 0;
+		const size_t endY = std::min(chunkY + 2, heightChunks);
+
+		for (size_t currentChunkY = startY; currentChunkY < endY; ++currentChunkY) {
+			for (size_t currentChunkX = startX; currentChunkX < endX; ++currentChunkX) {
+				const size_t chunkIndex = currentChunkY * widthChunks + currentChunkX;
+				for (size_t entry = world.chunkStarts[chunkIndex]; entry < world.chunkStarts[chunkIndex + 1]; ++entry) {
+					if (world.chunkObjects[entry] > index) {
+						world.pairCandidates.push_back(world.chunkObjects[entry]);
+					}
 				}
-				else if (currentDynamicObject->getCurrentDirection().y != 0.f) {
-					currentDynamicObject->getTargetPosition() = glm::vec2(static_cast<unsigned int>(currentDynamicObject->getCurrentPosition().x / 4.f + 0.5f) * 4.f, currentDynamicObject->getCurrentPosition().y);
+			}
+		}
+		// the pairs are resolved in the same order as when every pair is tested
+		std::sort(world.pairCandidates.begin(), world.pairCandidates.end());
+	}
+
+	ECollisionDirection PhysicsEngine::getCollisionDirection(const glm::vec2& direction) {
+		if (direction.x < 0) return ECollisionDirection::Left;
+		if (direction.y > 0) return ECollisionDirection::Top;
+		if (direction.y < 0) return ECollisionDirection::Bottom;
+		return ECollisionDirection::Right;
+	}
+
+	ECollisionDirection PhysicsEngine::getOppositeDirection(const ECollisionDirection direction) {
+		switch (direction)
+		{
+		case ECollisionDirection::Top:
+			return ECollisionDirection::Bottom;
+		case ECollisionDirection::Bottom:
+			return ECollisionDirection::Top;
+		case ECollisionDirection::Left:
+			return ECollisionDirection::Right;
+		case ECollisionDirection::Right:
+			return ECollisionDirection::Left;
+		}
+		return ECollisionDirection::Left;
+	}
+
+	void PhysicsEngine::notifyCollision(const DynamicBody& body1, const DynamicBody& body2) {
+		const ECollisionDirection direction1 = getCollisionDirection(*body1.direction);
+		const ECollisionDirection direction2 = getCollisionDirection(*body2.direction);
+		for (const auto& collider1 : *body1.colliders) {
+			for (const auto& collider2 : *body2.colliders) {
+				if (collider1.isActive && collider2.isActive && hasCollidersIntersection(collider1, *body1.targetPosition, collider2, *body2.targetPosition)) {
+					if (collider1.onCollisionCallback) {
+						collider1.onCollisionCallback(*body2.object, direction1);
+					}
+					if (collider2.onCollisionCallback) {
+						collider2.onCollisionCallback(*body1.object, direction2);
+					}
 				}
+			}
+		}
+	}
 
-				const auto newPosition = currentDynamicObject->getTargetPosition() + currentDynamicObject->getCurrentDirection() * static_cast<float>(currentDynamicObject->getCurrentVelocity() * delta);
-				std::vector<std::shared_ptr<IGameObject>> objectsToCheck = m_currentLevel->getObjectsInArea(newPosition, newPosition + currentDynamicObject->getSize());
+	void PhysicsEngine::calculateTargetPositions(std::vector<DynamicBody>& bodies, const double delta) {
+		for (DynamicBody& currentBody : bodies) {
+			IGameObject& currentDynamicObject = *currentBody.object;
+			const glm::vec2& position = *currentBody.position;
+			glm::vec2& targetPosition = *currentBody.targetPosition;
+			const glm::vec2& direction = *currentBody.direction;
+			const double objectDelta = currentDynamicObject.getSimulationDelta(delta);
+			if (currentDynamicObject.getCurrentVelocity() > 0 && objectDelta > 0) {
+				if (direction.x != 0.f) {
+					targetPosition = glm::vec2(position.x, static_cast<unsigned int>(position.y / 4.f + 0.5f) * 4.f);
+				}
+				else if (direction.y != 0.f) {
+					targetPosition = glm::vec2(static_cast<unsigned int>(position.x / 4.f + 0.5f) * 4.f, position.y);
+				}
 
-				const auto& colliders = currentDynamicObject->getColliders();
-				bool hasCollision = false;
+				const auto newPosition = targetPosition + direction * static_cast<float>(currentDynamicObject.getCurrentVelocity() * objectDelta);
+				auto& objectsToCheck = m_currentWorld->objectsInArea;
+				m_currentWorld->currentLevel->getObjectsInArea(newPosition, newPosition + currentDynamicObject.getSize(), objectsToCheck);
 
-				ECollisionDirection dynamicObjectCollisionDirection = ECollisionDirection::Right;
-				if (currentDynamicObject->getCurrentDirection().x < 0) dynamicObjectCollisionDirection = ECollisionDirection::Left;
-				else if (currentDynamicObject->getCurrentDirection().y > 0) dynamicObjectCollisionDirection = ECollisionDirection::Top;
-				else if (currentDynamicObject->getCurrentDirection().y < 0) dynamicObjectCollisionDirection = ECollisionDirection::Bottom;
+				const auto& colliders = *currentBody.colliders;
+				bool hasCollision = false;
 
-				ECollisionDirection objectCollisionDirection = ECollisionDirection::Left;
-				if (currentDynamicObject->getCurrentDirection().x < 0) objectCollisionDirection = ECollisionDirection::Right;
-				else if (currentDynamicObject->getCurrentDirection().y > 0) objectCollisionDirection = ECollisionDirection::Bottom;
-				else if (currentDynamicObject->getCurrentDirection().y < 0) objectCollisionDirection = ECollisionDirection::Top;
+				const ECollisionDirection dynamicObjectCollisionDirection = getCollisionDirection(direction);
+				const ECollisionDirection objectCollisionDirection = getOppositeDirection(dynamicObjectCollisionDirection);
 
 				for (const auto& currentDynamicObjectCollider : colliders) {
 					for (const auto& currentObjectToCheck : objectsToCheck) {
 						const auto& collidersToCheck = currentObjectToCheck->getColliders();
-						if (currentObjectToCheck->collides(currentDynamicObject->getObjectType()) && !collidersToCheck.empty()) {
+						if (currentObjectToCheck->collides(currentDynamicObject.getObjectType()) && !collidersToCheck.empty()) {
 							for (const auto& currentObjectCollider : currentObjectToCheck->getColliders()) {
 								if (currentObjectCollider.isActive && hasCollidersIntersection(currentDynamicObjectCollider, newPosition, currentObjectCollider, currentObjectToCheck->getCurrentPosition())) {
 									hasCollision = true;
 									if (currentObjectCollider.onCollisionCallback) {
-										currentObjectCollider.onCollisionCallback(*currentDynamicObject, objectCollisionDirection);
+										currentObjectCollider.onCollisionCallback(currentDynamicObject, objectCollisionDirection);
 									}
 									if (currentDynamicObjectCollider.onCollisionCallback) {
 										currentDynamicObjectCollider.onCollisionCallback(*currentObjectToCheck, dynamicObjectCollisionDirection);
@@ -100,37 +219,54 @@ namespace Physics {
 				}
 
 				if (!hasCollision) {
-					currentDynamicObject->getTargetPosition() = newPosition;
+					targetPosition = newPosition;
 				}
 				else {
-					if (currentDynamicObject->getCurrentDirection().x != 0.f) {
-						currentDynamicObject->getTargetPosition() = glm::vec2(static_cast<unsigned int>(currentDynamicObject->getTargetPosition().x / 4.f + 0.5f) * 4.f, currentDynamicObject->getTargetPosition().y);
+					if (direction.x != 0.f) {
+						targetPosition = glm::vec2(static_cast<unsigned int>(targetPosition.x / 4.f + 0.5f) * 4.f, targetPosition.y);
 					}
-					else if (currentDynamicObject->getCurrentDirection().y != 0.f) {
-						currentDynamicObject->getTargetPosition() = glm::vec2(currentDynamicObject->getTargetPosition().x, static_cast<unsigned int>(currentDynamicObject->getTargetPosition().y / 4.f + 0.5f) * 4.f);
+					else if (direction.y != 0.f) {
+						targetPosition = glm::vec2(targetPosition.x, static_cast<unsigned int>(targetPosition.y / 4.f + 0.5f) * 4.f);
 					}
 				}
 			}
 		}
 	}
 	
-	void PhysicsEngine::updatePositions(std::unordered_set<std::shared_ptr<IGameObject>>& dynamicObjects) {
-		for (auto& currentDynamicObject : dynamicObjects) {
-			currentDynamicObject->getCurrentPosition() = currentDynamicObject->getTargetPosition();
+	void PhysicsEngine::updatePositions(std::vector<DynamicBody>& bodies) {
+		for (DynamicBody& currentBody : bodies) {
+			*currentBody.position = *currentBody.targetPosition;
 		}
 	}
 
 	void PhysicsEngine::addDynamicGameObject(std::shared_ptr<IGameObject> gameObject) {
-		m_dynamicObjects.insert(std::move(gameObject));
+		if (gameObject->m_physicsIndex != IGameObject::INVALID_PHYSICS_INDEX) {
+			return;
+		}
+		gameObject->m_physicsIndex = m_currentWorld->dynamicObjects.size();
+		m_currentWorld->dynamicObjects.push_back(std::move(gameObject));
+	}
+
+	void PhysicsEngine::removeDynamicGameObject(IGameObject& gameObject) {
+		const size_t index = gameObject.m_physicsIndex;
+		if (index == IGameObject::INVALID_PHYSICS_INDEX) {
+			return;
+		}
+		gameObject.m_physicsIndex = IGameObject::INVALID_PHYSICS_INDEX;
+
+		auto& dynamicObjects = m_currentWorld->dynamicObjects;
+		if (index != dynamicObjects.size() - 1) {
+			dynamicObjects[index] = std::move(dynamicObjects.back());
+			dynamicObjects[index]->m_physicsIndex = index;
+		}
+		dynamicObjects.pop_back();
 	}
 
-	bool PhysicsEngine::hasPositionIntersection(const std::shared_ptr<IGameObject>& object1, const glm::vec2& position1,
-		const std::shared_ptr<IGameObject>& object2, const glm::vec2& position2) {
-		const auto& currentObjectColliders = object1->getColliders();
-		const auto& otherObjectColliders = object2->getColliders();
-		for (const auto& currentObjectCollider : currentObjectColliders) {
-			for (const auto& otherObjectCollider : otherObjectColliders) {
-				if (hasCollidersIntersection(currentObjectCollider, position1, otherObjectCollider, position2)) {
+	bool PhysicsEngine::hasPositionIntersection(const ColliderList& colliders1, const glm::vec2& position1,
+		const ColliderList& colliders2, const glm::vec2& position2) {
+		for (const auto& collider1 : colliders1) {
+			for (const auto& collider2 : colliders2) {
+				if (hasCollidersIntersection(collider1, position1, collider2, position2)) {
 					return true;
 				}
 			}
@@ -1,9 +1,11 @@
 #pragma once
 
-#include <unordered_set>
 #include <memory>
 #include <vector>
-#include <functional>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
 
 #include <glm/vec2.hpp>
 
@@ -20,6 +22,7 @@ namespace Physics {
 	};
 
 	struct AABB {
+		AABB() = default;
 		AABB(const glm::vec2& _bottomLeft, const glm::vec2& _topRight)
 			: bottomLeft(_bottomLeft)
 			, topRight(_topRight)
@@ -28,21 +31,103 @@ namespace Physics {
 		glm::vec2 topRight;
 	};
 
+	// plain function pointer with the object it is called for, userData is passed back to the callback
+	struct CollisionCallback {
+		typedef void (*Function)(void* owner, const uint8_t userData, const IGameObject& object, const ECollisionDirection direction);
+
+		template <class T, void (T::*Method)(const IGameObject&, const ECollisionDirection, const uint8_t)>
+		static CollisionCallback bind(T* owner, const uint8_t userData = 0) {
+			CollisionCallback callback;
+			callback.function = [](void* owner, const uint8_t userData, const IGameObject& object, const ECollisionDirection direction)
+			{
+				(static_cast<T*>(owner)->*Method)(object, direction, userData);
+			};
+			callback.owner = owner;
+			callback.userData = userData;
+			return callback;
+		}
+
+		explicit operator bool() const { return function != nullptr; }
+		void operator()(const IGameObject& object, const ECollisionDirection direction) const { function(owner, userData, object, direction); }
+
+		Function function = nullptr;
+		void* owner = nullptr;
+		uint8_t userData = 0;
+	};
+
 	struct Collider {
-		Collider(const glm::vec2& _bottomLeft, const glm::vec2& _topRight, std::function<void(const IGameObject&, const ECollisionDirection)> _onCollisionCallback = {})
+		Collider() = default;
+		Collider(const glm::vec2& _bottomLeft, const glm::vec2& _topRight, const CollisionCallback _onCollisionCallback = {})
 			: boundingBox(_bottomLeft, _topRight)
 			, isActive(true)
 			, onCollisionCallback(_onCollisionCallback)
 		{}
 
-		Collider(const AABB& _boundingBox, std::function<void(const IGameObject&, const ECollisionDirection)> _onCollisionCallback = {})
+		Collider(const AABB& _boundingBox, const CollisionCallback _onCollisionCallback = {})
 			: boundingBox(_boundingBox)
 			, isActive(true)
 			, onCollisionCallback(_onCollisionCallback)
 		{}
 		AABB boundingBox;
-		bool isActive;
-		std::function<void(const IGameObject&, const ECollisionDirection)> onCollisionCallback;
+		bool isActive = false;
+		CollisionCallback onCollisionCallback;
+	};
+
+	static_assert(std::is_trivially_copyable_v<Collider>, "colliders are copied as raw memory");
+
+	// colliders stored inline in the object, no object has more than CAPACITY of them
+	class ColliderList {
+	public:
+		static constexpr size_t CAPACITY = 4;
+
+		template <class... Args>
+		Collider& emplace_back(Args&&... args) {
+			assert(m_count < CAPACITY);
+			m_colliders[m_count] = Collider(std::forward<Args>(args)...);
+			return m_colliders[m_count++];
+		}
+
+		Collider& operator[](const size_t index) { return m_colliders[index]; }
+		const Collider& operator[](const size_t index) const { return m_colliders[index]; }
+		size_t size() const { return m_count; }
+		bool empty() const { return m_count == 0; }
+
+		const Collider* begin() const { return m_colliders.data(); }
+		const Collider* end() const { return m_colliders.data() + m_count; }
+
+	private:
+		std::array<Collider, CAPACITY> m_colliders;
+		uint8_t m_count = 0;
+	};
+
+	static_assert(std::is_trivially_copyable_v<ColliderList>, "colliders are copied as raw memory");
+
+	// components of a dynamic object, resolved once per update: the objects only change them in place
+	// while the engine runs, so the references stay valid until it returns
+	struct DynamicBody {
+		IGameObject* object;
+		glm::vec2* position;
+		glm::vec2* targetPosition;
+		glm::vec2* direction;
+		const ColliderList* colliders;
+	};
+
+	// dynamic objects and level of one simulation, several of them can be stepped side by side
+	struct PhysicsWorld {
+		// objects know their index here, so adding and removing never searches or allocates
+		std::vector<std::shared_ptr<IGameObject>> dynamicObjects;
+		std::shared_ptr<Level> currentLevel;
+
+		// scratch buffers of the update, kept so the ticks don't allocate
+		// bodies of the dynamic objects, in the same order
+		std::vector<DynamicBody> bodies;
+		// level chunk of every dynamic object
+		std::vector<size_t> objectChunks;
+		// dynamic objects ordered by chunk, those of chunk i are at [chunkStarts[i], chunkStarts[i + 1])
+		std::vector<size_t> chunkStarts;
+		std::vector<size_t> chunkObjects;
+		std::vector<size_t> pairCandidates;
+		std::vector<IGameObject*> objectsInArea;
 	};
 
 	class PhysicsEngine {
@@ -59,19 +144,38 @@ namespace Physics {
 
 		static void update(const double delta);
 		static void addDynamicGameObject(std::shared_ptr<IGameObject> gameObject);
+		static void removeDynamicGameObject(IGameObject& gameObject);
+		// in the order the collisions are resolved in
+		static const std::vector<std::shared_ptr<IGameObject>>& getDynamicObjects() { return m_currentWorld->dynamicObjects; }
+		static void clearDynamicObjects();
 		static void setCurrentLevel(std::shared_ptr<Level> level);
+		// the engine works on the world current on the calling thread, nullptr selects the world of the game;
+		// returns the world that was current before
+		static PhysicsWorld* setCurrentWorld(PhysicsWorld* world);
 
 	private:
-		static std::unordered_set < std::shared_ptr<IGameObject>> m_dynamicObjects;
-		static std::shared_ptr<Level> m_currentLevel;
+		static PhysicsWorld m_defaultWorld;
+		static thread_local PhysicsWorld* m_currentWorld;
 
 		static bool hasCollidersIntersection(const Collider& collider1, const glm::vec2& position1,
 									const Collider& collider2, const glm::vec2& position2);
 
-		static bool hasPositionIntersection(const std::shared_ptr<IGameObject>& object1, const glm::vec2& position1, 
-											const std::shared_ptr<IGameObject>& object2, const glm::vec2& position2);
+		static bool hasPositionIntersection(const ColliderList& colliders1, const glm::vec2& position1,
+											const ColliderList& colliders2, const glm::vec2& position2);
+
+		// side of an object moving in direction that hits first
+		static ECollisionDirection getCollisionDirection(const glm::vec2& direction);
+		static ECollisionDirection getOppositeDirection(const ECollisionDirection direction);
+		// runs the collision callbacks of two dynamic objects that would overlap at their target positions
+		static void notifyCollision(const DynamicBody& body1, const DynamicBody& body2);
+
+		// sorts the dynamic objects of the world into the chunks of its level
+		static void sortIntoChunks(PhysicsWorld& world);
+		// dynamic objects after index that can collide with it, in the order of the dynamic objects
+		static void findPairCandidates(PhysicsWorld& world, const size_t index);
 
-		static void calculateTargetPositions(std::unordered_set<std::shared_ptr<IGameObject>>& dynamicObjects, const double delta);
-		static void updatePositions(std::unordered_set<std::shared_ptr<IGameObject>>& dynamicObjects);
+		static void gatherBodies(PhysicsWorld& world);
+		static void calculateTargetPositions(std::vector<DynamicBody>& bodies, const double delta);
+		static void updatePositions(std::vector<DynamicBody>& bodies);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+#include "AnimationSystem.h"
+
+#include "Sprite.h"
+#include "../System/Snapshot.h"
+
+#include <cmath>
+
+namespace RenderEngine {
+	AnimationSystem::AnimationSystem(const size_t initialCapacity) {
+		m_frameTime.reserve(initialCapacity);
+		m_frameDuration.reserve(initialCapacity);
+		m_playRate.reserve(initialCapacity);
+		m_currentFrame.reserve(initialCapacity);
+		m_framesTable.reserve(initialCapacity);
+		m_generation.reserve(initialCapacity);
+	}
+
+	uint32_t AnimationSystem::getFramesTable(const Sprite& sprite) {
+		const auto it = m_framesTablesBySprite.find(&sprite);
+		if (it != m_framesTablesBySprite.end()) {
+			return it->second;
+		}
+
+		FramesTable table{ static_cast<uint32_t>(m_frameDurations.size()), static_cast<uint32_t>(sprite.getFramesCount()), 0 };
+		for (size_t currentFrameID = 0; currentFrameID < table.count; ++currentFrameID) {
+			m_frameDurations.push_back(sprite.getFrameDuration(currentFrameID));
+			table.totalDuration += m_frameDurations.back();
+		}
+
+		const uint32_t tableIndex = static_cast<uint32_t>(m_framesTables.size());
+		m_framesTables.push_back(table);
+		m_framesTablesBySprite.emplace(&sprite, tableIndex);
+		return tableIndex;
+	}
+
+	AnimationSystem::Handle AnimationSystem::create(const std::shared_ptr<Sprite>& sprite, const bool isPlaying) {
+		uint32_t index;
+		if (!m_freeSlots.empty()) {
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(m_frameTime.size());
+			m_frameTime.push_back(0);
+			m_frameDuration.push_back(0);
+			m_playRate.push_back(0);
+			m_currentFrame.push_back(0);
+			m_framesTable.push_back(0);
+			m_generation.push_back(0);
+		}
+
+		m_framesTable[index] = getFramesTable(*sprite);
+		m_playRate[index] = isPlaying ? 1 : 0;
+		reset({ index, m_generation[index] });
+		return { index, m_generation[index] };
+	}
+
+	void AnimationSystem::destroy(Handle& handle) {
+		if (isValid(handle)) {
+			m_playRate[handle.index] = 0;
+			++m_generation[handle.index];
+			m_freeSlots.push_back(handle.index);
+		}
+		handle = Handle();
+	}
+
+	bool AnimationSystem::isValid(const Handle& handle) const {
+		return handle.index < m_generation.size() && m_generation[handle.index] == handle.generation;
+	}
+
+	void AnimationSystem::preload(const std::shared_ptr<Sprite>& sprite) {
+		getFramesTable(*sprite);
+	}
+
+	void AnimationSystem::setSprite(const Handle& handle, const std::shared_ptr<Sprite>& sprite) {
+		m_framesTable[handle.index] = getFramesTable(*sprite);
+		reset(handle);
+	}
+
+	void AnimationSystem::setPlaying(const Handle& handle, const bool isPlaying) {
+		m_playRate[handle.index] = isPlaying ? 1 : 0;
+	}
+
+	void AnimationSystem::reset(const Handle& handle) {
+		const FramesTable& table = m_framesTables[m_framesTable[handle.index]];
+		m_currentFrame[handle.index] = 0;
+		m_frameTime[handle.index] = 0;
+		// animations without a duration stay on the first frame
+		m_frameDuration[handle.index] = table.totalDuration > 0 ? m_frameDurations[table.offset] : HUGE_VAL;
+	}
+
+	size_t AnimationSystem::getCurrentFrame(const Handle& handle) const {
+		return m_currentFrame[handle.index];
+	}
+
+	double AnimationSystem::getTotalDuration(const Handle& handle) const {
+		return m_framesTables[m_framesTable[handle.index]].totalDuration;
+	}
+
+	void AnimationSystem::advanceFrames(const size_t index) {
+		const FramesTable& table = m_framesTables[m_framesTable[index]];
+		// whole cycles end on the same frame
+		if (m_frameTime[index] >= table.totalDuration) {
+			m_frameTime[index] = std::fmod(m_frameTime[index], table.totalDuration);
+		}
+
+		while (m_frameTime[index] >= m_frameDuration[index]) {
+			m_frameTime[index] -= m_frameDuration[index];
+			++m_currentFrame[index];
+
+			if (m_currentFrame[index] == table.count) {
+				m_currentFrame[index] = 0;
+			}
+			m_frameDuration[index] = m_frameDurations[table.offset + m_currentFrame[index]];
+		}
+	}
+
+	void AnimationSystem::update(const double delta) {
+		const size_t animationsCount = m_frameTime.size();
+		double* frameTime = m_frameTime.data();
+		const double* frameDuration = m_frameDuration.data();
+		const double* playRate = m_playRate.data();
+
+		// branchless pass over all animations, the compiler vectorises it
+		size_t frameChanges = 0;
+		for (size_t currentAnimation = 0; currentAnimation < animationsCount; ++currentAnimation) {
+			frameTime[currentAnimation] += delta * playRate[currentAnimation];
+			frameChanges += frameTime[currentAnimation] >= frameDuration[currentAnimation];
+		}
+
+		if (frameChanges == 0) {
+			return;
+		}
+		for (size_t currentAnimation = 0; currentAnimation < animationsCount; ++currentAnimation) {
+			if (frameTime[currentAnimation] >= frameDuration[currentAnimation]) {
+				advanceFrames(currentAnimation);
+			}
+		}
+	}
+
+	void AnimationSystem::saveState(SnapshotWriter& writer) const {
+		writer.write(static_cast<uint64_t>(m_framesTables.size()));
+		writer.writeVector(m_frameTime);
+		writer.writeVector(m_frameDuration);
+		writer.writeVector(m_playRate);
+		writer.writeVector(m_currentFrame);
+		writer.writeVector(m_framesTable);
+		writer.writeVector(m_generation);
+		writer.writeVector(m_freeSlots);
+	}
+
+	bool AnimationSystem::readState(SnapshotReader& reader, SavedState& state) const {
+		uint64_t framesTablesCount = 0;
+		if (!reader.read(framesTablesCount) || framesTablesCount > m_framesTables.size()) {
+			return false;
+		}
+		if (!reader.readVector(state.frameTime) || !reader.readVector(state.frameDuration) || !reader.readVector(state.playRate)
+			|| !reader.readVector(state.currentFrame) || !reader.readVector(state.framesTable) || !reader.readVector(state.generation)
+			|| !reader.readVector(state.freeSlots)) {
+			return false;
+		}
+
+		// the objects outside of the snapshot keep their handles, so the animations have to be the same
+		const size_t animationsCount = m_frameTime.size();
+		if (state.frameTime.size() != animationsCount || state.frameDuration.size() != animationsCount || state.playRate.size() != animationsCount
+			|| state.currentFrame.size() != animationsCount || state.framesTable.size() != animationsCount || state.generation.size() != animationsCount) {
+			return false;
+		}
+		for (size_t currentAnimation = 0; currentAnimation < animationsCount; ++currentAnimation) {
+			if (state.framesTable[currentAnimation] >= framesTablesCount) {
+				return false;
+			}
+			const FramesTable& table = m_framesTables[state.framesTable[currentAnimation]];
+			if ((state.currentFrame[currentAnimation] >= table.count && state.currentFrame[currentAnimation] != 0)
+				|| (state.playRate[currentAnimation] != 0 && state.playRate[currentAnimation] != 1)) {
+				return false;
+			}
+		}
+		std::vector<bool> isFree(animationsCount, false);
+		for (const uint32_t currentSlot : state.freeSlots) {
+			if (currentSlot >= animationsCount || isFree[currentSlot]) {
+				return false;
+			}
+			isFree[currentSlot] = true;
+		}
+		return true;
+	}
+
+	void AnimationSystem::restoreState(const SavedState& state) {
+		m_frameTime = state.frameTime;
+		m_frameDuration = state.frameDuration;
+		m_playRate = state.playRate;
+		m_currentFrame = state.currentFrame;
+		m_framesTable = state.framesTable;
+		m_generation = state.generation;
+		m_freeSlots = state.freeSlots;
+	}
+}
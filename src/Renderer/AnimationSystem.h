@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+namespace RenderEngine {
+
+	class Sprite;
+
+	// Frame animations of one game state, stored as parallel arrays and advanced in a single pass.
+	// Objects keep a handle and read the current frame through it, animations that run
+	// on the same clock (all water tiles) can share one handle.
+	class AnimationSystem {
+	public:
+		struct Handle {
+			uint32_t index = INVALID_INDEX;
+			uint32_t generation = 0;
+		};
+
+		static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+		explicit AnimationSystem(const size_t initialCapacity = 64);
+
+		AnimationSystem(const AnimationSystem&) = delete;
+		AnimationSystem& operator = (const AnimationSystem&) = delete;
+
+		Handle create(const std::shared_ptr<Sprite>& sprite, const bool isPlaying = true);
+		void destroy(Handle& handle);
+		bool isValid(const Handle& handle) const;
+		// registers the frames of a sprite ahead of time, so switching to it later does not allocate
+		void preload(const std::shared_ptr<Sprite>& sprite);
+		// switches the animation to another sprite and rewinds it
+		void setSprite(const Handle& handle, const std::shared_ptr<Sprite>& sprite);
+
+		// paused animations keep their current frame
+		void setPlaying(const Handle& handle, const bool isPlaying);
+		void reset(const Handle& handle);
+		size_t getCurrentFrame(const Handle& handle) const;
+		double getTotalDuration(const Handle& handle) const;
+
+		void update(const double delta);
+		size_t getAnimationsCount() const { return m_frameTime.size() - m_freeSlots.size(); }
+
+		// frames tables are referenced by index, the system restoring the state
+		// must have registered the sprites in the same order and created as many animations
+		struct SavedState;
+		void saveState(SnapshotWriter& writer) const;
+		// reads the state and checks it against the frames tables, the system itself is not changed
+		bool readState(SnapshotReader& reader, SavedState& state) const;
+		void restoreState(const SavedState& state);
+
+	private:
+		// run of frame durations of one sprite in m_frameDurations
+		struct FramesTable {
+			uint32_t offset;
+			uint32_t count;
+			double totalDuration;
+		};
+
+		uint32_t getFramesTable(const Sprite& sprite);
+		void advanceFrames(const size_t index);
+
+		std::vector<double> m_frameDurations;
+		std::vector<FramesTable> m_framesTables;
+		std::unordered_map<const Sprite*, uint32_t> m_framesTablesBySprite;
+
+		// one entry per animation
+		std::vector<double> m_frameTime;
+		std::vector<double> m_frameDuration;
+		// 1 while playing, 0 while paused or free, so the time step needs no branch
+		std::vector<double> m_playRate;
+		std::vector<uint32_t> m_currentFrame;
+		std::vector<uint32_t> m_framesTable;
+		std::vector<uint32_t> m_generation;
+		std::vector<uint32_t> m_freeSlots;
+	};
+
+	struct AnimationSystem::SavedState {
+		bool isValid(const Handle& handle) const { return handle.index < generation.size() && generation[handle.index] == handle.generation; }
+
+		std::vector<double> frameTime;
+		std::vector<double> frameDuration;
+		std::vector<double> playRate;
+		std::vector<uint32_t> currentFrame;
+		std::vector<uint32_t> framesTable;
+		std::vector<uint32_t> generation;
+		std::vector<uint32_t> freeSlots;
+	};
+}
@@ -0,0 +1,144 @@
+// Definitions of the renderer classes for the headless build, which has no GL context.
+// Textures and sprites keep their sizes, sub-textures and frames, so animations advance
+// as usual; everything that would reach the GPU does nothing.
+#include "Renderer.h"
+#include "ShaderProgram.h"
+#include "Texture2D.h"
+#include "Sprite.h"
+#include "VertexArray.h"
+#include "VertexBuffer.h"
+#include "IndexBuffer.h"
+
+namespace RenderEngine {
+
+	VertexBuffer::VertexBuffer() : m_id(0) {}
+	VertexBuffer::~VertexBuffer() {}
+	VertexBuffer::VertexBuffer(VertexBuffer&&) noexcept : m_id(0) {}
+	VertexBuffer& VertexBuffer::operator = (VertexBuffer&&) noexcept { return *this; }
+	void VertexBuffer::init(const void*, const unsigned int) {}
+	void VertexBuffer::update(const void*, const unsigned int) const {}
+	void VertexBuffer::bind() const {}
+	void VertexBuffer::unbind() const {}
+
+	IndexBuffer::IndexBuffer() : m_id(0), m_count(0) {}
+	IndexBuffer::~IndexBuffer() {}
+	IndexBuffer::IndexBuffer(IndexBuffer&& indexBuffer) noexcept : m_id(0), m_count(indexBuffer.m_count) {}
+	IndexBuffer& IndexBuffer::operator = (IndexBuffer&& indexBuffer) noexcept {
+		m_count = indexBuffer.m_count;
+		return *this;
+	}
+	void IndexBuffer::init(const void*, const unsigned int count) { m_count = count; }
+	void IndexBuffer::bind() const {}
+	void IndexBuffer::unbind() const {}
+
+	VertexArray::VertexArray() {}
+	VertexArray::~VertexArray() {}
+	VertexArray::VertexArray(VertexArray&&) noexcept {}
+	VertexArray& VertexArray::operator = (VertexArray&&) noexcept { return *this; }
+	void VertexArray::addBuffer(const VertexBuffer&, const VertexBufferLayout&) {}
+	void VertexArray::bind() const {}
+	void VertexArray::unbind() const {}
+
+	void Renderer::draw(const VertexArray&, const IndexBuffer&, const ShaderProgram&) {}
+	void Renderer::setClearColor(const float, const float, const float, const float) {}
+	void Renderer::setDepthTest(const bool) {}
+	void Renderer::clear() {}
+	void Renderer::setViewport(unsigned int, unsigned int, unsigned int, unsigned int) {}
+	std::string Renderer::getRendererStr() { return "headless"; }
+	std::string Renderer::getVersionStr() { return "none"; }
+
+	// the sources are not compiled, a program is always usable
+	ShaderProgram::ShaderProgram(const std::string&, const std::string&)
+		: m_isCompiled(true)
+	{
+	}
+	ShaderProgram::~ShaderProgram() {}
+	ShaderProgram& ShaderProgram::operator = (ShaderProgram&& shaderProgram) noexcept {
+		m_isCompiled = shaderProgram.m_isCompiled;
+		shaderProgram.m_isCompiled = false;
+		return *this;
+	}
+	ShaderProgram::ShaderProgram(ShaderProgram&& shaderProgram) noexcept
+		: m_isCompiled(shaderProgram.m_isCompiled)
+	{
+		shaderProgram.m_isCompiled = false;
+	}
+	bool ShaderProgram::createShader(const std::string&, const GLenum, GLuint&) { return true; }
+	void ShaderProgram::use() const {}
+	void ShaderProgram::setInt(const std::string&, const GLint) {}
+	void ShaderProgram::setFloat(const std::string&, const GLfloat) {}
+	void ShaderProgram::setMatrix4(const std::string&, glm::mat4&) {}
+
+	// only the size of the image is known, its pixels are never loaded
+	Texture2D::Texture2D(const GLuint width, const GLuint height,
+		const unsigned char*,
+		const unsigned int channels,
+		const GLenum,
+		const GLenum)
+		: m_ID(0)
+		, m_mode(channels == 4 ? GL_RGBA : GL_RGB)
+		, m_width(width)
+		, m_height(height)
+	{
+	}
+
+	Texture2D& Texture2D::operator = (Texture2D&& texture2d) {
+		m_mode = texture2d.m_mode;
+		m_width = texture2d.m_width;
+		m_height = texture2d.m_height;
+		m_subTextures = std::move(texture2d.m_subTextures);
+		return *this;
+	}
+
+	Texture2D::Texture2D(Texture2D&& texture2d)
+		: m_ID(0)
+		, m_mode(texture2d.m_mode)
+		, m_width(texture2d.m_width)
+		, m_height(texture2d.m_height)
+		, m_subTextures(std::move(texture2d.m_subTextures))
+	{
+	}
+
+	Texture2D::~Texture2D() {}
+	void Texture2D::bind() const {}
+
+	void Texture2D::addSubTexture(std::string name, const glm::vec2& leftBottomUV, const glm::vec2& rightTopUV) {
+		m_subTextures.emplace(std::move(name), SubTexture2D(leftBottomUV, rightTopUV));
+	}
+
+	const Texture2D::SubTexture2D& Texture2D::getSubTexture(const std::string& name) const {
+		auto it = m_subTextures.find(name);
+		if (it != m_subTextures.end()) {
+			return it->second;
+		}
+		const static SubTexture2D defaultSubTexture;
+		return defaultSubTexture;
+	}
+
+	Sprite::Sprite(const std::shared_ptr<Texture2D> texture,
+		const std::string,
+		const std::shared_ptr<ShaderProgram> shaderProgram)
+		: m_texture(std::move(texture))
+		, m_shaderProgram(std::move(shaderProgram))
+		, m_lastFrameID(0)
+	{
+	}
+
+	Sprite::~Sprite() {}
+
+	void Sprite::render(const glm::vec2&, const glm::vec2&, const float, const float, const size_t frameID) const {
+		m_lastFrameID = frameID;
+	}
+
+	void Sprite::insertFrames(std::vector<FrameDescription> framesDescriptions) {
+		m_framesDescriptions = std::move(framesDescriptions);
+	}
+
+	double Sprite::getFrameDuration(const size_t frameID) const {
+		return m_framesDescriptions[frameID].duration;
+	}
+
+	size_t Sprite::getFramesCount() const {
+		return m_framesDescriptions.size();
+	}
+}
\ No newline at end of file
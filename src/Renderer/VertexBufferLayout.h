@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <cstddef>
 #include <glad/glad.h>
 
 namespace RenderEngine {
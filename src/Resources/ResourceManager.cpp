@@ -85,6 +85,14 @@ std::shared_ptr <RenderEngine::Texture2D> ResourceManager::loadTexture(const std
 	int width = 0;
 	int height = 0;
 
+#if defined(BATTLECITY_HEADLESS)
+	// without a GL context only the size of the image is used, the pixels are not decoded
+	if (!stbi_info(std::string(m_path + "/" + texturePath).c_str(), &width, &height, &channels)) {
+		std::cerr << "Can't load image: " << texturePath << std::endl;
+		return nullptr;
+	}
+	unsigned char* pixels = nullptr;
+#else
 	stbi_set_flip_vertically_on_load(true);
 	unsigned char* pixels = stbi_load(std::string(m_path + "/" + texturePath).c_str(), &width, &height, &channels, 0);
 
@@ -92,6 +100,7 @@ std::shared_ptr <RenderEngine::Texture2D> ResourceManager::loadTexture(const std
 		std::cerr << "Can't load image: " << texturePath << std::endl;
 		return nullptr;
 	}
+#endif
 
 	std::shared_ptr <RenderEngine::Texture2D> newTexture = m_textures.emplace(textureName, std::make_shared<RenderEngine::Texture2D>(width, 
 																															 height, 
@@ -0,0 +1,123 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// One bit per cell of a grid, stored line by line in 64 bit words.
+// Scans along a line test a whole word per step instead of a cell.
+class Bitboard {
+public:
+	static constexpr int NOT_FOUND = -1;
+
+	void reset(const size_t lineLength, const size_t linesCount) {
+		m_lineLength = lineLength;
+		m_linesCount = linesCount;
+		m_lineWords = (lineLength + 63) / 64;
+		m_words.assign(m_lineWords * linesCount, 0);
+	}
+
+	void clear() { m_words.assign(m_words.size(), 0); }
+
+	size_t getLineLength() const { return m_lineLength; }
+	size_t getLinesCount() const { return m_linesCount; }
+
+	bool get(const size_t line, const size_t position) const {
+		return (m_words[line * m_lineWords + position / 64] >> (position % 64)) & 1;
+	}
+
+	// sets or clears the bits of the line in [from, to)
+	void setRange(const size_t line, const size_t from, const size_t to, const bool value) {
+		for (size_t position = from; position < to;) {
+			const size_t wordEnd = std::min<size_t>((position / 64 + 1) * 64, to);
+			const uint64_t mask = getMask(position % 64, wordEnd - position);
+			uint64_t& word = m_words[line * m_lineWords + position / 64];
+			word = value ? word | mask : word & ~mask;
+			position = wordEnd;
+		}
+	}
+
+	// whether any bit of the line in [from, to) is set
+	bool hasAny(const size_t line, const size_t from, const size_t to) const {
+		for (size_t position = from; position < to;) {
+			const size_t wordEnd = std::min<size_t>((position / 64 + 1) * 64, to);
+			if (m_words[line * m_lineWords + position / 64] & getMask(position % 64, wordEnd - position)) {
+				return true;
+			}
+			position = wordEnd;
+		}
+		return false;
+	}
+
+	// first set bit of the line at or after from, NOT_FOUND if there is none
+	int findForward(const size_t line, const size_t from) const {
+		if (from >= m_lineLength) {
+			return NOT_FOUND;
+		}
+		size_t wordIndex = from / 64;
+		uint64_t word = m_words[line * m_lineWords + wordIndex] & (~uint64_t(0) << (from % 64));
+		while (true) {
+			if (word) {
+				const size_t position = wordIndex * 64 + findLowestBit(word);
+				return position < m_lineLength ? static_cast<int>(position) : NOT_FOUND;
+			}
+			if (++wordIndex == m_lineWords) {
+				return NOT_FOUND;
+			}
+			word = m_words[line * m_lineWords + wordIndex];
+		}
+	}
+
+	// last set bit of the line at or before from, NOT_FOUND if there is none
+	int findBackward(const size_t line, const size_t from) const {
+		if (from >= m_lineLength) {
+			return NOT_FOUND;
+		}
+		size_t wordIndex = from / 64;
+		uint64_t word = m_words[line * m_lineWords + wordIndex] & (~uint64_t(0) >> (63 - from % 64));
+		while (true) {
+			if (word) {
+				return static_cast<int>(wordIndex * 64 + findHighestBit(word));
+			}
+			if (wordIndex-- == 0) {
+				return NOT_FOUND;
+			}
+			word = m_words[line * m_lineWords + wordIndex];
+		}
+	}
+
+private:
+	static uint64_t getMask(const size_t offset, const size_t count) {
+		return (count == 64 ? ~uint64_t(0) : (uint64_t(1) << count) - 1) << offset;
+	}
+
+	static size_t findLowestBit(const uint64_t word) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanForward64(&index, word);
+		return index;
+#else
+		return static_cast<size_t>(__builtin_ctzll(word));
+#endif
+	}
+
+	static size_t findHighestBit(const uint64_t word) {
+#if defined(_MSC_VER)
+		unsigned long index;
+		_BitScanReverse64(&index, word);
+		return index;
+#else
+		return 63 - static_cast<size_t>(__builtin_clzll(word));
+#endif
+	}
+
+	std::vector<uint64_t> m_words;
+	size_t m_lineLength = 0;
+	size_t m_linesCount = 0;
+	size_t m_lineWords = 0;
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "MonotonicArena.h"
+
+#include <cstdint>
+
+MonotonicArena::MonotonicArena(const size_t blockSize)
+	: m_blockSize(blockSize)
+	, m_offset(0)
+	, m_usedBytes(0)
+{
+}
+
+MonotonicArena::~MonotonicArena() {
+	release();
+}
+
+void MonotonicArena::addBlock(const size_t minSize) {
+	const size_t size = minSize > m_blockSize ? minSize : m_blockSize;
+	m_blocks.push_back({ std::make_unique<std::byte[]>(size), size });
+	m_offset = 0;
+}
+
+void* MonotonicArena::allocate(const size_t size, const size_t alignment) {
+	if (!m_blocks.empty()) {
+		const Block& block = m_blocks.back();
+		const uintptr_t begin = reinterpret_cast<uintptr_t>(block.data.get());
+		const size_t alignedOffset = ((begin + m_offset + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1)) - begin;
+		if (alignedOffset + size <= block.size) {
+			m_offset = alignedOffset + size;
+			m_usedBytes += size;
+			return block.data.get() + alignedOffset;
+		}
+	}
+
+	// a fresh block is aligned for any fundamental type, the worst case padding is added for the rest
+	addBlock(size + alignment);
+	return allocate(size, alignment);
+}
+
+void MonotonicArena::release() {
+	m_blocks.clear();
+	m_offset = 0;
+	m_usedBytes = 0;
+}
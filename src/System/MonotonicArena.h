@@ -0,0 +1,83 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <utility>
+
+// Bump allocator that takes memory in large blocks and gives it back all at once.
+// Deallocation is a no-op: objects placed into the arena still run their destructors
+// through their owners, the memory itself is reclaimed when the arena is released.
+class MonotonicArena {
+public:
+	// unique_ptr deleter for objects in the arena, only runs the destructor
+	struct Destroyer {
+		template <class T>
+		void operator()(T* object) const { object->~T(); }
+	};
+
+	template <class T>
+	using UniquePtr = std::unique_ptr<T, Destroyer>;
+
+	// allocator for the standard containers and std::allocate_shared
+	template <class T>
+	class Allocator {
+	public:
+		typedef T value_type;
+
+		explicit Allocator(MonotonicArena* arena) : m_arena(arena) {}
+		template <class U>
+		Allocator(const Allocator<U>& other) : m_arena(other.getArena()) {}
+
+		T* allocate(const size_t count) { return static_cast<T*>(m_arena->allocate(count * sizeof(T), alignof(T))); }
+		void deallocate(T*, const size_t) {}
+
+		MonotonicArena* getArena() const { return m_arena; }
+
+		template <class U>
+		bool operator == (const Allocator<U>& other) const { return m_arena == other.getArena(); }
+		template <class U>
+		bool operator != (const Allocator<U>& other) const { return m_arena != other.getArena(); }
+
+	private:
+		MonotonicArena* m_arena;
+	};
+
+	explicit MonotonicArena(const size_t blockSize = 64 * 1024);
+	~MonotonicArena();
+
+	MonotonicArena(const MonotonicArena&) = delete;
+	MonotonicArena& operator = (const MonotonicArena&) = delete;
+
+	void* allocate(const size_t size, const size_t alignment);
+	// frees every block, nothing allocated from the arena may be alive at this point
+	void release();
+
+	// object and shared_ptr control block in one arena allocation
+	template <class T, class... Args>
+	std::shared_ptr<T> makeShared(Args&&... args) {
+		return std::allocate_shared<T>(Allocator<T>(this), std::forward<Args>(args)...);
+	}
+
+	template <class T, class... Args>
+	UniquePtr<T> makeUnique(Args&&... args) {
+		return UniquePtr<T>(new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...));
+	}
+
+	size_t getBlocksCount() const { return m_blocks.size(); }
+	size_t getUsedBytes() const { return m_usedBytes; }
+
+private:
+	struct Block {
+		std::unique_ptr<std::byte[]> data;
+		size_t size;
+	};
+
+	void addBlock(const size_t minSize);
+
+	std::vector<Block> m_blocks;
+	size_t m_blockSize;
+	// offset of the free space in the last block
+	size_t m_offset;
+	size_t m_usedBytes;
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include "Snapshot.h"
+
+// Values stored densely in one array and addressed through generational handles.
+// Insertion and erasure are O(1), erasure moves the last value into the gap.
+// A handle to an erased value stays safe to use: lookups through it return nullptr.
+template <class T>
+class SlotMap {
+public:
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+	struct Handle {
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+	};
+
+	void reserve(const size_t capacity) {
+		m_values.reserve(capacity);
+		m_denseToSlot.reserve(capacity);
+		m_slots.reserve(capacity);
+	}
+
+	Handle insert(T value) {
+		uint32_t slotIndex;
+		if (m_freeSlots != INVALID_INDEX) {
+			slotIndex = m_freeSlots;
+			m_freeSlots = m_slots[slotIndex].denseIndex;
+		}
+		else {
+			slotIndex = static_cast<uint32_t>(m_slots.size());
+			m_slots.emplace_back();
+		}
+
+		Slot& slot = m_slots[slotIndex];
+		slot.denseIndex = static_cast<uint32_t>(m_values.size());
+		m_values.push_back(std::move(value));
+		m_denseToSlot.push_back(slotIndex);
+		return { slotIndex, slot.generation };
+	}
+
+	bool erase(const Handle& handle) {
+		if (!contains(handle)) {
+			return false;
+		}
+		eraseAt(m_slots[handle.index].denseIndex);
+		return true;
+	}
+
+	// erases the value at the position of the dense array, the last value takes its place
+	void eraseAt(const size_t denseIndex) {
+		const uint32_t slotIndex = m_denseToSlot[denseIndex];
+		const size_t lastIndex = m_values.size() - 1;
+		if (denseIndex != lastIndex) {
+			m_values[denseIndex] = std::move(m_values[lastIndex]);
+			m_denseToSlot[denseIndex] = m_denseToSlot[lastIndex];
+			m_slots[m_denseToSlot[denseIndex]].denseIndex = static_cast<uint32_t>(denseIndex);
+		}
+		m_values.pop_back();
+		m_denseToSlot.pop_back();
+
+		Slot& slot = m_slots[slotIndex];
+		++slot.generation;
+		slot.denseIndex = m_freeSlots;
+		m_freeSlots = slotIndex;
+	}
+
+	void clear() {
+		while (!m_values.empty()) {
+			eraseAt(m_values.size() - 1);
+		}
+	}
+
+	bool contains(const Handle& handle) const {
+		return handle.index < m_slots.size() && m_slots[handle.index].generation == handle.generation;
+	}
+
+	T* get(const Handle& handle) { return contains(handle) ? &m_values[m_slots[handle.index].denseIndex] : nullptr; }
+	const T* get(const Handle& handle) const { return contains(handle) ? &m_values[m_slots[handle.index].denseIndex] : nullptr; }
+
+	Handle getHandle(const size_t denseIndex) const {
+		const uint32_t slotIndex = m_denseToSlot[denseIndex];
+		return { slotIndex, m_slots[slotIndex].generation };
+	}
+
+	T& operator[](const size_t denseIndex) { return m_values[denseIndex]; }
+	const T& operator[](const size_t denseIndex) const { return m_values[denseIndex]; }
+
+	size_t size() const { return m_values.size(); }
+	bool empty() const { return m_values.empty(); }
+
+	typename std::vector<T>::iterator begin() { return m_values.begin(); }
+	typename std::vector<T>::iterator end() { return m_values.end(); }
+	typename std::vector<T>::const_iterator begin() const { return m_values.begin(); }
+	typename std::vector<T>::const_iterator end() const { return m_values.end(); }
+
+	// values are copied as raw memory, so T has to be trivially copyable
+	struct SavedState;
+	void saveState(SnapshotWriter& writer) const {
+		writer.writeVector(m_values);
+		writer.writeVector(m_denseToSlot);
+		writer.writeVector(m_slots);
+		writer.write(m_freeSlots);
+	}
+
+	// reads the state and checks that every slot is either used by one value or free, the map is not changed;
+	// the values themselves are checked by the owner
+	bool readState(SnapshotReader& reader, SavedState& state) const {
+		if (!reader.readVector(state.values) || !reader.readVector(state.denseToSlot) || !reader.readVector(state.slots) || !reader.read(state.freeSlots)) {
+			return false;
+		}
+		if (state.denseToSlot.size() != state.values.size()) {
+			return false;
+		}
+		std::vector<bool> isListed(state.slots.size(), false);
+		for (size_t denseIndex = 0; denseIndex < state.denseToSlot.size(); ++denseIndex) {
+			const uint32_t slotIndex = state.denseToSlot[denseIndex];
+			if (slotIndex >= state.slots.size() || isListed[slotIndex] || state.slots[slotIndex].denseIndex != denseIndex) {
+				return false;
+			}
+			isListed[slotIndex] = true;
+		}
+		for (uint32_t slotIndex = state.freeSlots; slotIndex != INVALID_INDEX; slotIndex = state.slots[slotIndex].denseIndex) {
+			if (slotIndex >= state.slots.size() || isListed[slotIndex]) {
+				return false;
+			}
+			isListed[slotIndex] = true;
+		}
+		return std::find(isListed.begin(), isListed.end(), false) == isListed.end();
+	}
+
+	void restoreState(const SavedState& state) {
+		m_values = state.values;
+		m_denseToSlot = state.denseToSlot;
+		m_slots = state.slots;
+		m_freeSlots = state.freeSlots;
+	}
+
+private:
+	// the generation changes when the value is erased, so old handles no longer match
+	struct Slot {
+		// position of the value in the dense array, or the next free slot while the slot is free
+		uint32_t denseIndex = 0;
+		uint32_t generation = 0;
+	};
+
+	std::vector<T> m_values;
+	std::vector<uint32_t> m_denseToSlot;
+	std::vector<Slot> m_slots;
+	uint32_t m_freeSlots = INVALID_INDEX;
+};
+
+template <class T>
+struct SlotMap<T>::SavedState {
+	std::vector<T> values;
+	std::vector<uint32_t> denseToSlot;
+	std::vector<Slot> slots;
+	uint32_t freeSlots = INVALID_INDEX;
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Flat binary state, written by one pass over the objects and read back by the same pass.
+// Only trivially copyable values go in, so both directions are plain memory copies;
+// objects refer to each other through indices and handles, never through pointers.
+class SnapshotWriter {
+public:
+	explicit SnapshotWriter(std::vector<uint8_t>& buffer) : m_buffer(buffer) {}
+
+	template <class T>
+	void write(const T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written");
+		writeBytes(&value, sizeof(T));
+	}
+
+	// the count goes first, arrays of any size can be read back into a vector
+	template <class T>
+	void writeArray(const T* values, const size_t count) {
+		static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be written");
+		write(static_cast<uint64_t>(count));
+		writeBytes(values, count * sizeof(T));
+	}
+
+	template <class T>
+	void writeVector(const std::vector<T>& values) { writeArray(values.data(), values.size()); }
+
+	size_t getOffset() const { return m_buffer.size(); }
+	// overwrites a value written before, used for sizes known only at the end
+	template <class T>
+	void writeAt(const size_t offset, const T& value) { std::memcpy(m_buffer.data() + offset, &value, sizeof(T)); }
+
+private:
+	void writeBytes(const void* data, const size_t size) {
+		const size_t offset = m_buffer.size();
+		m_buffer.resize(offset + size);
+		if (size > 0) {
+			std::memcpy(m_buffer.data() + offset, data, size);
+		}
+	}
+
+	std::vector<uint8_t>& m_buffer;
+};
+
+// Reads what a SnapshotWriter wrote. A read past the end or an array of another size than
+// expected fails, nothing is read afterwards and the failed value is left as it was.
+class SnapshotReader {
+public:
+	SnapshotReader(const uint8_t* data, const size_t size)
+		: m_data(data)
+		, m_size(size)
+		, m_offset(0)
+		, m_isValid(true)
+	{}
+
+	template <class T>
+	bool read(T& value) {
+		static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read");
+		return readBytes(&value, sizeof(T));
+	}
+
+	// the array has to have been written with exactly count values
+	template <class T>
+	bool readArray(T* values, const size_t count) {
+		uint64_t writtenCount = 0;
+		if (!read(writtenCount) || writtenCount != count) {
+			m_isValid = false;
+			return false;
+		}
+		return readBytes(values, count * sizeof(T));
+	}
+
+	// resizes the vector to the written array
+	template <class T>
+	bool readVector(std::vector<T>& values) {
+		static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable values can be read");
+		uint64_t count = 0;
+		if (!read(count) || count > (m_size - m_offset) / (sizeof(T) > 0 ? sizeof(T) : 1)) {
+			m_isValid = false;
+			return false;
+		}
+		values.resize(static_cast<size_t>(count));
+		return readBytes(values.data(), values.size() * sizeof(T));
+	}
+
+	bool isValid() const { return m_isValid; }
+	bool isAtEnd() const { return m_offset == m_size; }
+
+	// a bool read as part of raw memory can hold any byte, it may only be used once it is 0 or 1
+	static bool isBool(const bool& value) {
+		uint8_t byte;
+		std::memcpy(&byte, &value, sizeof(byte));
+		return byte <= 1;
+	}
+
+private:
+	bool readBytes(void* data, const size_t size) {
+		if (!m_isValid || size > m_size - m_offset) {
+			m_isValid = false;
+			return false;
+		}
+		if (size > 0) {
+			std::memcpy(data, m_data + m_offset, size);
+		}
+		m_offset += size;
+		return true;
+	}
+
+	const uint8_t* m_data;
+	size_t m_size;
+	size_t m_offset;
+	bool m_isValid;
+};
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(const size_t threadsCount)
+	: m_isStopping(false)
+{
+	m_threads.reserve(threadsCount);
+	for (size_t currentThread = 0; currentThread < threadsCount; ++currentThread) {
+		m_threads.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_isStopping = true;
+	}
+	m_hasJobs.notify_all();
+	for (auto& currentThread : m_threads) {
+		currentThread.join();
+	}
+}
+
+ThreadPool& ThreadPool::getShared() {
+	static ThreadPool sharedPool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+	return sharedPool;
+}
+
+void ThreadPool::runJob(Job& job) {
+	size_t finishedCount = 0;
+	for (size_t index = job.nextIndex++; index < job.count; index = job.nextIndex++) {
+		(*job.function)(index);
+		++finishedCount;
+	}
+	if (finishedCount > 0 && job.finishedCount.fetch_add(finishedCount) + finishedCount == job.count) {
+		std::lock_guard<std::mutex> lock(job.mutex);
+		job.finished.notify_all();
+	}
+}
+
+void ThreadPool::parallelFor(const size_t count, const std::function<void(size_t)>& function) {
+	if (count == 0) {
+		return;
+	}
+	if (m_threads.empty() || count == 1) {
+		for (size_t index = 0; index < count; ++index) {
+			function(index);
+		}
+		return;
+	}
+
+	const auto job = std::make_shared<Job>();
+	job->function = &function;
+	job->count = count;
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_jobs.push_back(job);
+	}
+	m_hasJobs.notify_all();
+
+	runJob(*job);
+	{
+		// every index is taken, the workers don't have to look at the job anymore
+		std::lock_guard<std::mutex> lock(m_mutex);
+		const auto jobIt = std::find(m_jobs.begin(), m_jobs.end(), job);
+		if (jobIt != m_jobs.end()) {
+			m_jobs.erase(jobIt);
+		}
+	}
+	std::unique_lock<std::mutex> lock(job->mutex);
+	job->finished.wait(lock, [&job]() { return job->finishedCount == job->count; });
+}
+
+void ThreadPool::workerLoop() {
+	while (true) {
+		std::shared_ptr<Job> job;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_hasJobs.wait(lock, [this]() { return m_isStopping || !m_jobs.empty(); });
+			if (m_isStopping) {
+				return;
+			}
+			job = m_jobs.front();
+			if (job->nextIndex >= job->count) {
+				m_jobs.pop_front();
+				continue;
+			}
+		}
+		runJob(*job);
+	}
+}
\ No newline at end of file
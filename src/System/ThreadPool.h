@@ -0,0 +1,51 @@
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <cstddef>
+
+// Fixed set of worker threads running the iterations of parallel loops.
+// The calling thread works on its own loop too, so a loop started from a worker
+// (or on a pool without threads) still completes.
+class ThreadPool {
+public:
+	// threadsCount extra threads besides the calling one, 0 runs every loop on the calling thread
+	explicit ThreadPool(const size_t threadsCount);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator = (const ThreadPool&) = delete;
+
+	// calls function(index) for every index in [0, count), returns when all calls are finished
+	void parallelFor(const size_t count, const std::function<void(size_t)>& function);
+
+	size_t getThreadsCount() const { return m_threads.size(); }
+
+	// pool shared by the systems of the game, one thread less than the hardware has
+	static ThreadPool& getShared();
+
+private:
+	struct Job {
+		const std::function<void(size_t)>* function;
+		size_t count;
+		std::atomic<size_t> nextIndex{ 0 };
+		std::atomic<size_t> finishedCount{ 0 };
+		std::mutex mutex;
+		std::condition_variable finished;
+	};
+
+	static void runJob(Job& job);
+	void workerLoop();
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::shared_ptr<Job>> m_jobs;
+	std::mutex m_mutex;
+	std::condition_variable m_hasJobs;
+	bool m_isStopping;
+};
\ No newline at end of file
@@ -0,0 +1,226 @@
+#include "TimerWheel.h"
+
+#include "Snapshot.h"
+
+#include <algorithm>
+#include <cmath>
+
+TimerWheel::TimerWheel(const size_t initialCapacity)
+	: m_freeNodes(INVALID_INDEX)
+	, m_time(0)
+	, m_currentTick(1)
+	, m_scheduledCount(0)
+{
+	for (auto& currentLevel : m_slots) {
+		currentLevel.fill(INVALID_INDEX);
+	}
+	m_nodes.reserve(initialCapacity);
+	m_callbacks.reserve(initialCapacity);
+}
+
+uint32_t TimerWheel::allocateNode() {
+	if (m_freeNodes != INVALID_INDEX) {
+		const uint32_t index = m_freeNodes;
+		m_freeNodes = m_nodes[index].next;
+		return index;
+	}
+	m_nodes.emplace_back();
+	m_callbacks.emplace_back();
+	return static_cast<uint32_t>(m_nodes.size() - 1);
+}
+
+void TimerWheel::freeNode(const uint32_t index) {
+	Node& node = m_nodes[index];
+	node.isScheduled = false;
+	++node.generation;
+	node.previous = INVALID_INDEX;
+	node.next = m_freeNodes;
+	m_freeNodes = index;
+	--m_scheduledCount;
+}
+
+void TimerWheel::insert(const uint32_t index) {
+	Node& node = m_nodes[index];
+	const uint64_t expires = std::max(node.expires, m_currentTick);
+	const uint64_t ticksLeft = expires - m_currentTick;
+
+	size_t level = 0;
+	while (level < LEVELS_COUNT - 1 && ticksLeft >= (uint64_t(1) << (SLOT_BITS * (level + 1)))) {
+		++level;
+	}
+	// timers beyond the last level wait there and are cascaded again
+	const uint64_t slotTick = level == LEVELS_COUNT - 1 ? std::min(expires, m_currentTick + (uint64_t(1) << (SLOT_BITS * LEVELS_COUNT)) - 1) : expires;
+	const size_t slot = static_cast<size_t>((slotTick >> (SLOT_BITS * level)) & SLOT_MASK);
+
+	node.level = static_cast<uint8_t>(level);
+	node.slot = static_cast<uint8_t>(slot);
+	node.previous = INVALID_INDEX;
+	node.next = m_slots[level][slot];
+	if (node.next != INVALID_INDEX) {
+		m_nodes[node.next].previous = index;
+	}
+	m_slots[level][slot] = index;
+}
+
+void TimerWheel::unlink(const uint32_t index) {
+	Node& node = m_nodes[index];
+	if (node.previous != INVALID_INDEX) {
+		m_nodes[node.previous].next = node.next;
+	}
+	else {
+		m_slots[node.level][node.slot] = node.next;
+	}
+	if (node.next != INVALID_INDEX) {
+		m_nodes[node.next].previous = node.previous;
+	}
+}
+
+TimerWheel::Handle TimerWheel::schedule(const double delay, const Callback callback) {
+	const uint32_t index = allocateNode();
+	Node& node = m_nodes[index];
+	m_callbacks[index] = callback;
+	node.expires = static_cast<uint64_t>(std::ceil(m_time + std::max(delay, 0.0)));
+	node.isScheduled = true;
+	++m_scheduledCount;
+	insert(index);
+	return { index, node.generation };
+}
+
+void TimerWheel::cancel(Handle& handle) {
+	if (isScheduled(handle)) {
+		unlink(handle.index);
+		freeNode(handle.index);
+	}
+	handle = Handle();
+}
+
+bool TimerWheel::isScheduled(const Handle& handle) const {
+	return handle.index < m_nodes.size() && m_nodes[handle.index].generation == handle.generation && m_nodes[handle.index].isScheduled;
+}
+
+double TimerWheel::getTimeLeft(const Handle& handle) const {
+	if (!isScheduled(handle)) {
+		return 0;
+	}
+	return std::max(static_cast<double>(m_nodes[handle.index].expires) - m_time, 0.0);
+}
+
+void TimerWheel::cascade(const size_t level) {
+	const size_t slot = static_cast<size_t>((m_currentTick >> (SLOT_BITS * level)) & SLOT_MASK);
+	uint32_t index = m_slots[level][slot];
+	m_slots[level][slot] = INVALID_INDEX;
+	while (index != INVALID_INDEX) {
+		const uint32_t next = m_nodes[index].next;
+		insert(index);
+		index = next;
+	}
+}
+
+void TimerWheel::runTick() {
+	for (size_t level = 1; level < LEVELS_COUNT && ((m_currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) == 0; ++level) {
+		cascade(level);
+	}
+
+	// one timer at a time, callbacks may schedule or cancel other timers
+	const size_t slot = static_cast<size_t>(m_currentTick & SLOT_MASK);
+	uint32_t index = m_slots[0][slot];
+	while (index != INVALID_INDEX) {
+		unlink(index);
+		if (m_nodes[index].expires > m_currentTick) {
+			// was parked in the last level for more than a full turn of the wheel
+			insert(index);
+		}
+		else {
+			const Callback callback = m_callbacks[index];
+			freeNode(index);
+			// a restored timer nobody bound again has nothing to call
+			if (callback.function) {
+				callback();
+			}
+		}
+		index = m_slots[0][slot];
+	}
+	++m_currentTick;
+}
+
+void TimerWheel::update(const double delta) {
+	m_time += delta;
+	const uint64_t lastTick = static_cast<uint64_t>(m_time);
+	if (m_scheduledCount == 0) {
+		m_currentTick = std::max(m_currentTick, lastTick + 1);
+		return;
+	}
+	while (m_currentTick <= lastTick) {
+		runTick();
+	}
+}
+
+
+void TimerWheel::saveState(SnapshotWriter& writer) const {
+	writer.writeVector(m_nodes);
+	writer.write(m_freeNodes);
+	writer.write(m_slots);
+	writer.write(m_time);
+	writer.write(m_currentTick);
+	writer.write(static_cast<uint64_t>(m_scheduledCount));
+}
+
+bool TimerWheel::readState(SnapshotReader& reader, SavedState& state) const {
+	if (!reader.readVector(state.nodes) || !reader.read(state.freeNodes) || !reader.read(state.slots)
+		|| !reader.read(state.time) || !reader.read(state.currentTick) || !reader.read(state.scheduledCount)) {
+		return false;
+	}
+	// the wheel is always one tick past its time
+	if (!(state.time >= 0 && state.time < std::ldexp(1.0, 63)) || state.currentTick != static_cast<uint64_t>(state.time) + 1) {
+		return false;
+	}
+
+	// every node is in exactly one list: the slot it was inserted into while scheduled, the free list otherwise
+	for (const Node& currentNode : state.nodes) {
+		if (!SnapshotReader::isBool(currentNode.isScheduled)) {
+			return false;
+		}
+	}
+	std::vector<bool> isListed(state.nodes.size(), false);
+	uint64_t scheduledCount = 0;
+	for (size_t currentLevel = 0; currentLevel < LEVELS_COUNT; ++currentLevel) {
+		for (size_t currentSlot = 0; currentSlot < SLOTS_COUNT; ++currentSlot) {
+			uint32_t previous = INVALID_INDEX;
+			for (uint32_t index = state.slots[currentLevel][currentSlot]; index != INVALID_INDEX; index = state.nodes[index].next) {
+				if (index >= state.nodes.size() || isListed[index]) {
+					return false;
+				}
+				const Node& node = state.nodes[index];
+				if (!node.isScheduled || node.previous != previous || node.level != currentLevel || node.slot != currentSlot) {
+					return false;
+				}
+				isListed[index] = true;
+				previous = index;
+				++scheduledCount;
+			}
+		}
+	}
+	for (uint32_t index = state.freeNodes; index != INVALID_INDEX; index = state.nodes[index].next) {
+		if (index >= state.nodes.size() || isListed[index] || state.nodes[index].isScheduled) {
+			return false;
+		}
+		isListed[index] = true;
+	}
+	return scheduledCount == state.scheduledCount && std::find(isListed.begin(), isListed.end(), false) == isListed.end();
+}
+
+void TimerWheel::restoreState(const SavedState& state) {
+	m_nodes = state.nodes;
+	m_freeNodes = state.freeNodes;
+	m_slots = state.slots;
+	m_time = state.time;
+	m_currentTick = state.currentTick;
+	m_scheduledCount = static_cast<size_t>(state.scheduledCount);
+	m_callbacks.assign(m_nodes.size(), Callback());
+}
+
+void TimerWheel::setCallback(const Handle& handle, const Callback callback) {
+	if (isScheduled(handle)) {
+		m_callbacks[handle.index] = callback;
+	}
+}
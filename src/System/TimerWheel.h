@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+class SnapshotWriter;
+class SnapshotReader;
+
+// Hierarchical timing wheel with 1 ms resolution.
+// Scheduling and cancellation are O(1), update() only touches timers that are due.
+class TimerWheel {
+public:
+	// plain function pointer with the object it is called for
+	struct Callback {
+		typedef void (*Function)(void* owner);
+
+		template <class T, void (T::*Method)()>
+		static Callback bind(T* owner) {
+			Callback callback;
+			callback.function = [](void* owner)
+			{
+				(static_cast<T*>(owner)->*Method)();
+			};
+			callback.owner = owner;
+			return callback;
+		}
+
+		void operator()() const { function(owner); }
+
+		Function function = nullptr;
+		void* owner = nullptr;
+	};
+
+	struct Handle {
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+	};
+
+	static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+	explicit TimerWheel(const size_t initialCapacity = 64);
+
+	TimerWheel(const TimerWheel&) = delete;
+	TimerWheel& operator = (const TimerWheel&) = delete;
+
+	Handle schedule(const double delay, const Callback callback);
+	void cancel(Handle& handle);
+	bool isScheduled(const Handle& handle) const;
+	double getTimeLeft(const Handle& handle) const;
+
+	void update(const double delta);
+	size_t getScheduledCount() const { return m_scheduledCount; }
+
+	// the snapshot holds no callbacks, the owners of the timers bind them again after a restore
+	struct SavedState;
+	void saveState(SnapshotWriter& writer) const;
+	// reads the state and checks the lists of the nodes, the wheel itself is not changed
+	bool readState(SnapshotReader& reader, SavedState& state) const;
+	void restoreState(const SavedState& state);
+	void setCallback(const Handle& handle, const Callback callback);
+
+private:
+	static constexpr size_t LEVELS_COUNT = 4;
+	static constexpr size_t SLOT_BITS = 6;
+	static constexpr size_t SLOTS_COUNT = 1 << SLOT_BITS;
+	static constexpr uint64_t SLOT_MASK = SLOTS_COUNT - 1;
+
+	// the callback of a node is kept in m_callbacks, so the nodes are only indices and times
+	struct Node {
+		uint64_t expires = 0;
+		uint32_t previous = INVALID_INDEX;
+		uint32_t next = INVALID_INDEX;
+		uint32_t generation = 0;
+		uint8_t level = 0;
+		uint8_t slot = 0;
+		bool isScheduled = false;
+	};
+
+	uint32_t allocateNode();
+	void freeNode(const uint32_t index);
+	void insert(const uint32_t index);
+	void unlink(const uint32_t index);
+	void cascade(const size_t level);
+	void runTick();
+
+	std::vector<Node> m_nodes;
+	std::vector<Callback> m_callbacks;
+	uint32_t m_freeNodes;
+	std::array<std::array<uint32_t, SLOTS_COUNT>, LEVELS_COUNT> m_slots;
+
+	double m_time;
+	// every tick before this one has already been processed
+	uint64_t m_currentTick;
+	size_t m_scheduledCount;
+};
+
+struct TimerWheel::SavedState {
+	std::vector<Node> nodes;
+	uint32_t freeNodes = INVALID_INDEX;
+	std::array<std::array<uint32_t, SLOTS_COUNT>, LEVELS_COUNT> slots;
+	double time = 0;
+	uint64_t currentTick = 0;
+	uint64_t scheduledCount = 0;
+};
@@ -1,9 +1,16 @@
+#if !defined(BATTLECITY_HEADLESS)
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#endif
 #include <glm/vec2.hpp>
 
 #include <iostream>
 #include <chrono>
+#include <thread>
+#include <string>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
 
 #include "Game/Game.h"
 #include "Resources/ResourceManager.h"
@@ -17,6 +24,124 @@ static constexpr unsigned int BLOCK_SIZE = 16;
 glm::uvec2 g_windowSize(SCALE * 16 * BLOCK_SIZE, SCALE * 15 * BLOCK_SIZE);
 std::unique_ptr<Game> g_game = std::make_unique<Game>(g_windowSize);
 
+// --agent <name> [--two-players]: the players are controlled through the shared memory block <name>
+static void attachAgent(int argc, char** argv) {
+    std::string agentChannelName;
+    Game::EGameMode eAgentGameMode = Game::EGameMode::OnePlayer;
+    for (int currentArgument = 1; currentArgument < argc; ++currentArgument) {
+        const std::string argument = argv[currentArgument];
+        if (argument == "--agent" && currentArgument + 1 < argc) {
+            agentChannelName = argv[++currentArgument];
+        }
+        else if (argument == "--two-players") {
+            eAgentGameMode = Game::EGameMode::TwoPlayers;
+        }
+    }
+    if (!agentChannelName.empty() && !g_game->attachAgent(agentChannelName, eAgentGameMode)) {
+        std::cout << "Can't attach agent " << agentChannelName << std::endl;
+    }
+}
+
+// value following the argument, empty if the argument is not given
+static std::string getArgumentValue(int argc, char** argv, const std::string& name) {
+    for (int currentArgument = 1; currentArgument + 1 < argc; ++currentArgument) {
+        if (argv[currentArgument] == name) {
+            return argv[currentArgument + 1];
+        }
+    }
+    return std::string();
+}
+
+// --replay <file>: the game plays the recorded input, false if there is nothing to replay
+static bool startReplay(int argc, char** argv) {
+    const std::string replayPath = getArgumentValue(argc, argv, "--replay");
+    if (replayPath.empty()) {
+        return false;
+    }
+    if (!g_game->startReplay(replayPath)) {
+        std::cout << "Can't replay " << replayPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// --record <file>: the input from now on is recorded
+static void startRecording(int argc, char** argv) {
+    const std::string recordPath = getArgumentValue(argc, argv, "--record");
+    if (!recordPath.empty() && !g_game->startRecording(recordPath)) {
+        std::cout << "Can't record " << recordPath << std::endl;
+    }
+}
+
+#if defined(BATTLECITY_HEADLESS)
+
+// --ticks <n>: stops after n ticks, 0 runs until the process is stopped
+// --time-scale <scale>: simulated time per real time, 0 runs the ticks as fast as possible
+// a replay stops once its last tick is played
+int main(int argc, char** argv)
+{
+    uint64_t ticksCount = 0;
+    double timeScale = 0;
+    for (int currentArgument = 1; currentArgument + 1 < argc; ++currentArgument) {
+        const std::string argument = argv[currentArgument];
+        if (argument == "--ticks") {
+            const char* value = argv[++currentArgument];
+            char* valueEnd = nullptr;
+            errno = 0;
+            ticksCount = std::strtoull(value, &valueEnd, 10);
+            if (!std::isdigit(static_cast<unsigned char>(value[0])) || *valueEnd != '\0' || errno == ERANGE) {
+                std::cout << "Usage: --ticks <n>, n is a whole number of ticks, got " << value << std::endl;
+                return -1;
+            }
+        }
+        else if (argument == "--time-scale") {
+            const char* value = argv[++currentArgument];
+            char* valueEnd = nullptr;
+            errno = 0;
+            timeScale = std::strtod(value, &valueEnd);
+            if (valueEnd == value || *valueEnd != '\0' || errno == ERANGE || !(timeScale >= 0)) {
+                std::cout << "Usage: --time-scale <scale>, scale is a number not below 0, got " << value << std::endl;
+                return -1;
+            }
+        }
+    }
+
+    ResourceManager::setExecutablePath(argv[0]);
+    Physics::PhysicsEngine::init();
+    if (!g_game->init()) {
+        return -1;
+    }
+    attachAgent(argc, argv);
+    if (!startReplay(argc, argv) && !g_game->isAgentAttached()) {
+        // there is nobody to pick the menu entries, the first level starts right away
+        g_game->startNewLevel(0, Game::EGameMode::OnePlayer);
+    }
+    startRecording(argc, argv);
+
+    const auto startTime = std::chrono::steady_clock::now();
+    uint64_t currentTick = 0;
+    for (; ticksCount == 0 || currentTick < ticksCount; ++currentTick) {
+        g_game->update(Game::FIXED_TICK);
+        // the update that runs out of recorded ticks doesn't simulate one
+        if (g_game->isReplayFinished()) {
+            break;
+        }
+        if (timeScale > 0) {
+            const auto tickEnd = startTime + std::chrono::duration<double, std::milli>((currentTick + 1) * Game::FIXED_TICK / timeScale);
+            std::this_thread::sleep_until(tickEnd);
+        }
+    }
+
+    const double duration = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+    std::cout << "Simulated " << currentTick << " ticks in " << duration << " ms" << std::endl;
+
+    g_game->stopRecording();
+    Physics::PhysicsEngine::terminate();
+    g_game = nullptr;
+    ResourceManager::unloadResources();
+    return 0;
+}
+#else
 void glfwWindowSizeCallback(GLFWwindow* window, int width, int height) {
     g_windowSize.x = width;
     g_windowSize.y = height;
@@ -27,7 +152,10 @@ void glfwKeyCallback(GLFWwindow* window, int key, int scancode, int action, int
     if (key == GLFW_KEY_ESCAPE && action == GLFW_PRESS) {
         glfwSetWindowShouldClose(window, GL_TRUE);
     }
-    g_game->setKey(key, action);
+    // the replay presses the keys
+    if (!g_game->isReplaying()) {
+        g_game->setKey(key, action);
+    }
 }
 
 int main(int argc, char** argv)
@@ -72,6 +200,9 @@ int main(int argc, char** argv)
         ResourceManager::setExecutablePath(argv[0]);
         Physics::PhysicsEngine::init();
         g_game->init();
+        attachAgent(argc, argv);
+        startReplay(argc, argv);
+        startRecording(argc, argv);
 
         //glfwSetWindowSize(window, static_cast<int>(3 * g_game->getCurrentWidth()), static_cast<int>(3 * g_game->getCurrentHeight()));
 
@@ -87,7 +218,6 @@ int main(int argc, char** argv)
             double duration = std::chrono::duration<double, std::milli> (currentTime - lastTime).count();
             lastTime = currentTime;
             g_game->update(duration);
-            Physics::PhysicsEngine::update(duration);
 
             /* Render here */
             RenderEngine::Renderer::clear();
@@ -97,6 +227,7 @@ int main(int argc, char** argv)
             /* Swap front and back buffers */
             glfwSwapBuffers(window);
         }
+        g_game->stopRecording();
         Physics::PhysicsEngine::terminate();
         g_game = nullptr;
         ResourceManager::unloadResources();
@@ -104,4 +235,5 @@ int main(int argc, char** argv)
 
     glfwTerminate();
     return 0;
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file